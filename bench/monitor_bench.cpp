@@ -0,0 +1,663 @@
+#include <benchmark/benchmark.h>
+#include <curses.h>
+#include <malloc.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "collector.h"
+#include "exporter.h"
+#include "format.h"
+#include "frame.h"
+#include "instrument.h"
+#include "linux_parser.h"
+#include "proc_fixture.h"
+#include "process_table.h"
+#include "scheduler.h"
+#include "string_pool.h"
+#include "system.h"
+#include "system_snapshot.h"
+
+/*
+Benchmarks for the parsing and collection paths, run against a generated
+/proc tree (see proc_fixture.h) so that results do not depend on what the
+host happens to be running.
+
+  monitor_bench [--pids=N] [--threads=N] [--fixture=DIR] [--keep-fixture]
+                [--host] [benchmark flags]
+
+--threads is the number of threads per fake process. --host skips the
+fixture and measures the real /proc.
+BM_SystemProcessesBudget and BM_ScheduledReadsBudget need --pids=20000
+(or more). The run exits with status 1 when a refresh goes over its time
+or read budget, or when a check such as BM_ExportJsonEscapes fails.
+*/
+
+namespace {
+ProcFixture::Options options;
+std::vector<int> pids;
+bool failed = false;  // makes main() exit with status 1
+
+void BM_Pids(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(LinuxParser::Pids());
+  }
+  state.SetItemsProcessed(state.iterations() * pids.size());
+}
+BENCHMARK(BM_Pids);
+
+void BM_ReadProcStat(benchmark::State& state) {
+  LinuxParser::ProcStatSnapshot stat;
+  for (auto _ : state) {
+    for (int pid : pids) {
+      benchmark::DoNotOptimize(LinuxParser::ReadProcStat(pid, stat));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * pids.size());
+}
+BENCHMARK(BM_ReadProcStat);
+
+// Parsing alone, without the read
+void BM_ParseProcStat(benchmark::State& state) {
+  const char line[] =
+      "4242 (Web (Content)) S 1 4242 4242 0 -1 4194560 55146 0 1 0 3386 712 "
+      "0 0 20 0 31 0 8623 3386744832 101733 18446744073709551615 1 1 0 0 0 0 "
+      "0 4096 17663 0 0 0 17 5 0 0 0 0 0 0 0 0 0 0 0 0 0\n";
+  LinuxParser::ProcStatSnapshot stat;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        LinuxParser::ParseProcStat(line, sizeof(line) - 1, stat));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseProcStat);
+
+void BM_ReadMemInfo(benchmark::State& state) {
+  LinuxParser::MemInfo info;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(LinuxParser::ReadMemInfo(info));
+  }
+}
+BENCHMARK(BM_ReadMemInfo);
+
+// The system wide files: stat, meminfo, uptime, diskstats, loadavg and
+// pressure, one pread() each
+void BM_SystemSampler(benchmark::State& state) {
+  SystemSampler sampler;
+  SystemSnapshot snapshot;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sampler.Refresh(snapshot));
+  }
+}
+BENCHMARK(BM_SystemSampler);
+
+void BM_ReadProcStatus(benchmark::State& state) {
+  LinuxParser::ProcStatusSnapshot status;
+  for (auto _ : state) {
+    for (int pid : pids) {
+      benchmark::DoNotOptimize(LinuxParser::ReadProcStatus(pid, status));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * pids.size());
+}
+BENCHMARK(BM_ReadProcStatus);
+
+void BM_Command(benchmark::State& state) {
+  for (auto _ : state) {
+    for (int pid : pids) {
+      benchmark::DoNotOptimize(LinuxParser::Command(pid));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * pids.size());
+}
+BENCHMARK(BM_Command);
+
+void BM_ReadSmapsRollup(benchmark::State& state) {
+  LinuxParser::SmapsRollupSnapshot detail;
+  for (auto _ : state) {
+    for (int pid : pids) {
+      benchmark::DoNotOptimize(LinuxParser::ReadSmapsRollup(pid, detail));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * pids.size());
+}
+BENCHMARK(BM_ReadSmapsRollup);
+
+void BM_ReadProcIo(benchmark::State& state) {
+  LinuxParser::ProcIoSnapshot io;
+  for (auto _ : state) {
+    for (int pid : pids) {
+      benchmark::DoNotOptimize(LinuxParser::ReadProcIo(pid, io));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * pids.size());
+}
+BENCHMARK(BM_ReadProcIo);
+
+void BM_User(benchmark::State& state) {
+  for (auto _ : state) {
+    for (int pid : pids) {
+      benchmark::DoNotOptimize(LinuxParser::User(pid));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * pids.size());
+}
+BENCHMARK(BM_User);
+
+// A steady-state refresh (every PID already in the table) with the given
+// number of collector threads
+void BM_SystemProcesses(benchmark::State& state) {
+  System system(state.range(0));
+  system.Processes();
+  for (auto _ : state) {
+    system.Refresh();
+    benchmark::DoNotOptimize(system.Processes().data());
+  }
+  state.SetItemsProcessed(state.iterations() * pids.size());
+}
+BENCHMARK(BM_SystemProcesses)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// The scan has to keep up on a large host: at kBudgetPids processes no
+// steady-state refresh may take longer than kTickBudget, a quarter of the
+// default interval
+constexpr std::size_t kBudgetPids = 20000;
+constexpr double kTickBudget = 250.0;  // milliseconds
+
+void BM_SystemProcessesBudget(benchmark::State& state) {
+  if (pids.size() < kBudgetPids) {
+    state.SkipWithError("needs --pids=20000");
+    return;
+  }
+  System system;
+  system.Processes();
+  double total = 0.0;
+  double worst = 0.0;
+  for (auto _ : state) {
+    auto start = std::chrono::steady_clock::now();
+    system.Refresh();
+    benchmark::DoNotOptimize(system.Processes().data());
+    double tick = std::chrono::duration<double, std::milli>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+    total += tick;
+    worst = std::max(worst, tick);
+  }
+  state.counters["tick_ms"] = total / state.iterations();
+  state.counters["worst_tick_ms"] = worst;
+  state.counters["budget_ms"] = kTickBudget;
+  if (worst > kTickBudget) {
+    failed = true;
+    state.SetLabel("OVER BUDGET");
+  }
+}
+BENCHMARK(BM_SystemProcessesBudget)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// The background reads of each scheduled source, over every refresh of its
+// longest period at kBudgetPids processes, ten of them listed: no refresh
+// may cost more than Scheduler::kBackgroundBudget
+void BM_ScheduledReadsBudget(benchmark::State& state) {
+  if (pids.size() < kBudgetPids) {
+    state.SkipWithError("needs --pids=20000");
+    return;
+  }
+  std::size_t population = pids.size() - 10;
+  for (auto _ : state) {
+    for (int i = 0; i < Scheduler::kSources; ++i) {
+      auto source = static_cast<Scheduler::Source>(i);
+      unsigned long period = Scheduler::Period(source, population);
+      std::size_t worst = 0;
+      for (unsigned long tick = 1; tick <= period; ++tick) {
+        std::size_t reads = 0;
+        for (std::size_t j = 10; j < pids.size(); ++j) {
+          reads += Scheduler::Due(source, tick, 1, false, pids[j], population);
+        }
+        worst = std::max(worst, reads);
+      }
+      const Scheduler::Policy& policy = Scheduler::Of(source);
+      state.counters[std::string(policy.name) + "_reads"] = worst;
+      if (worst * policy.cost > Scheduler::kBackgroundBudget) {
+        failed = true;
+        state.SetLabel("OVER BUDGET");
+      }
+    }
+  }
+}
+BENCHMARK(BM_ScheduledReadsBudget)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+// CPU time of the whole process per tick of headless mode: collect a
+// snapshot without the sources Exporter::Run() turns off and encode it as
+// JSON Lines to /dev/null. core_percent_10hz is that cost at ten ticks a
+// second, in percent of one core; budget_hz the rate Run() slows to in
+// order to stay within Exporter::kCpuBudget.
+double ProcessCpuMilliseconds() {
+  timespec time;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+  return time.tv_sec * 1e3 + time.tv_nsec / 1e6;
+}
+
+void BM_HeadlessTick(benchmark::State& state) {
+  System system(state.range(0));
+  system.MemoryDetail(false);
+  Collector collector(system, 10, std::chrono::milliseconds(100));
+  Exporter exporter(Exporter::Encoding::kJsonLines);
+  if (!exporter.Open("/dev/null")) {
+    state.SkipWithError("cannot open /dev/null");
+    return;
+  }
+  Snapshot snapshot;
+  collector.CollectNow(snapshot);
+  double start = ProcessCpuMilliseconds();
+  for (auto _ : state) {
+    collector.CollectNow(snapshot);
+    exporter.Write(snapshot);
+  }
+  double cpu = (ProcessCpuMilliseconds() - start) / state.iterations();
+  state.counters["cpu_ms_per_tick"] = cpu;
+  state.counters["core_percent_10hz"] = cpu * 10 / 1000 * 100;
+  state.counters["budget_hz"] =
+      std::min(10.0, 1000 * Exporter::kCpuBudget / cpu);
+}
+BENCHMARK(BM_HeadlessTick)
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Encoding a record whose text is not valid UTF-8, then checking that the
+// line written is: bytes outside well-formed sequences become \ufffd,
+// well-formed ones pass through
+void BM_ExportJsonEscapes(benchmark::State& state) {
+  int fd = memfd_create("monitor_bench_export", 0);
+  Exporter exporter(Exporter::Encoding::kJsonLines);
+  if (fd < 0 ||
+      !exporter.Open("/proc/self/fd/" + std::to_string(fd))) {
+    state.SkipWithError("cannot open a memfd");
+    return;
+  }
+  Snapshot snapshot;
+  snapshot.processes.emplace_back(4242, "r\xc3\xa9mi", "a\xff\xe2\x82" "b c",
+                                  0.5f, 12, 100, 200);
+  DiskRate disk;
+  std::strcpy(disk.name, "sd\xed\xa0\x80");  // a UTF-16 surrogate
+  snapshot.disks.push_back(disk);
+  for (auto _ : state) {
+    exporter.Write(snapshot);
+  }
+  char line[4096];
+  ssize_t size = pread(fd, line, sizeof(line) - 1, 0);
+  close(fd);
+  line[std::max<ssize_t>(size, 0)] = '\0';
+  std::string_view text(line, std::max<ssize_t>(size, 0));
+  text = text.substr(0, text.find('\n'));
+  bool valid =
+      text.find("\"cmd\":\"a\\ufffd\\ufffd\\ufffdb c\"") != text.npos &&
+      text.find("\"user\":\"r\xc3\xa9mi\"") != text.npos &&
+      text.find("\"name\":\"sd\\ufffd\\ufffd\\ufffd\"") != text.npos;
+  for (unsigned char c : text) {
+    valid = valid && c != 0xff && c != 0xed;
+  }
+  if (!valid) {
+    failed = true;
+    state.SkipWithError(("invalid JSON: " + std::string(text)).c_str());
+  }
+}
+BENCHMARK(BM_ExportJsonEscapes);
+
+// Heap allocations per steady-state refresh, counted by the operator new
+// hook in instrument.cpp. Not timed: the counter is what matters.
+void BM_SystemProcessesAllocations(benchmark::State& state) {
+  if (!Instrument::kCompiled) {
+    state.SkipWithError("built with MONITOR_INSTRUMENT=0");
+    return;
+  }
+  System system(1);
+  system.Processes();
+  system.Processes();  // table, buffers and user names settle
+  Instrument::SetEnabled(true);
+  Instrument::Counters start = Instrument::Totals();
+  for (auto _ : state) {
+    system.Refresh();
+    benchmark::DoNotOptimize(system.Processes().data());
+  }
+  Instrument::Counters used = Instrument::Totals() - start;
+  Instrument::SetEnabled(false);
+  state.counters["allocations_per_refresh"] =
+      benchmark::Counter(double(used.allocations) / state.iterations());
+  state.counters["syscalls_per_refresh"] =
+      benchmark::Counter(double(used.syscalls) / state.iterations());
+}
+BENCHMARK(BM_SystemProcessesAllocations)->Unit(benchmark::kMillisecond);
+
+// A steady-state refresh with the threads of the top 10 expanded
+void BM_SystemProcessesThreadView(benchmark::State& state) {
+  System system(1);
+  system.ThreadView(true);
+  system.Processes();
+  for (auto _ : state) {
+    system.Refresh();
+    benchmark::DoNotOptimize(system.Processes().data());
+  }
+  state.SetItemsProcessed(state.iterations() * pids.size());
+}
+BENCHMARK(BM_SystemProcessesThreadView)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// A steady-state refresh laying out the whole process tree (the fixture's
+// PIDs form a tree three children wide)
+void BM_SystemProcessesTree(benchmark::State& state) {
+  System system(1);
+  system.TreeView(true);
+  system.Processes();
+  for (auto _ : state) {
+    system.Refresh();
+    benchmark::DoNotOptimize(system.Processes().data());
+  }
+  state.SetItemsProcessed(state.iterations() * pids.size());
+}
+BENCHMARK(BM_SystemProcessesTree)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// The first refresh, which also resolves every command and user
+void BM_SystemProcessesFirstScan(benchmark::State& state) {
+  for (auto _ : state) {
+    System system(state.range(0));
+    benchmark::DoNotOptimize(system.Processes().data());
+  }
+  state.SetItemsProcessed(state.iterations() * pids.size());
+}
+BENCHMARK(BM_SystemProcessesFirstScan)
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Text of a busy host: 20 users, 30 services, worker pools sharing 8
+// command lines, and a one-off command for every tenth process
+struct ProcessText {
+  std::vector<std::string> users, commands, cgroups;
+};
+
+ProcessText GenerateText(int processes) {
+  ProcessText text;
+  for (int i = 0; i < processes; ++i) {
+    text.users.push_back("user" + std::to_string(i % 20));
+    text.commands.push_back(
+        i % 10 == 0 ? "python3 /srv/jobs/run.py --job-id=" + std::to_string(i)
+                    : "/usr/lib/jvm/java-17/bin/java -Xmx2g -cp /opt/app/lib/* "
+                      "com.example.Worker --pool=" +
+                          std::to_string(i % 8));
+    text.cgroups.push_back("/system.slice/worker@" + std::to_string(i % 30) +
+                           ".service");
+  }
+  return text;
+}
+
+// Heap in use, as malloc counts it, including blocks it mmap()ed
+std::size_t HeapBytes() {
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+// Heap taken by the text of a 50k process table, kept as three strings
+// per process (arg 0) or as three interned handles (arg 1)
+void BM_ProcessTextFootprint(benchmark::State& state) {
+  constexpr int kProcesses = 50000;
+  ProcessText text = GenerateText(kProcesses);
+  struct Strings {
+    std::string user, command, cgroup;
+  };
+  struct Handles {
+    PooledString user, command, cgroup;
+  };
+  std::size_t bytes = 0;
+  for (auto _ : state) {
+    std::size_t before = HeapBytes();
+    if (state.range(0) == 0) {
+      std::vector<Strings> table;
+      table.reserve(kProcesses);
+      for (int i = 0; i < kProcesses; ++i) {
+        table.push_back({text.users[i], text.commands[i], text.cgroups[i]});
+      }
+      bytes = HeapBytes() - before;
+    } else {
+      std::vector<Handles> table;
+      table.reserve(kProcesses);
+      for (int i = 0; i < kProcesses; ++i) {
+        table.push_back({PooledString(text.users[i]),
+                         PooledString(text.commands[i]),
+                         PooledString(text.cgroups[i])});
+      }
+      bytes = HeapBytes() - before;
+    }
+  }
+  state.counters["bytes_per_process"] = double(bytes) / kProcesses;
+  state.SetLabel(state.range(0) == 0 ? "strings" : "pooled");
+}
+// One pass: freed pool blocks are kept for reuse, so later passes would
+// find most of their memory already counted
+BENCHMARK(BM_ProcessTextFootprint)
+    ->Arg(0)
+    ->Arg(1)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+// Filter 50k rows at a CPU threshold (arg, in percent; one row in eight
+// passes 5%) and pick the top 10 of those that passed
+void BM_ProcessTableRank(benchmark::State& state) {
+  constexpr int kProcesses = 50000;
+  ProcessText text = GenerateText(kProcesses);
+  ProcessTable table;
+  for (int i = 0; i < kProcesses; ++i) {
+    float cpu = i % 8 == 0 ? 0.05f + (i % 97) / 100.0f : (i % 5) / 1000.0f;
+    table.Append(Process(i + 1, text.users[i], text.commands[i], cpu,
+                         i % 1000, 0, 0));
+  }
+  ProcessTable::Filter filter;
+  filter.min_cpu = state.range(0) / 100.0f;
+  std::vector<std::uint32_t> order;
+  for (auto _ : state) {
+    std::size_t selected = table.Select(filter, order);
+    table.Rank(ProcessTable::Column::kCpu, order, selected, 10);
+    benchmark::DoNotOptimize(order.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kProcesses);
+}
+BENCHMARK(BM_ProcessTableRank)->Arg(0)->Arg(5);
+
+// A 120x45 ncurses screen whose output goes to an in-memory file, so the
+// bytes a refresh writes to the terminal can be counted. ncurses allows one
+// screen per benchmark run, so it is made once and kept.
+struct CountingTerminal {
+  CountingTerminal() {
+    setenv("LINES", "45", 1);
+    setenv("COLUMNS", "120", 1);
+    fd = memfd_create("monitor_bench_terminal", 0);
+    output = fdopen(fd, "w");
+    input = std::fopen("/dev/null", "r");
+    screen = newterm("xterm-256color", output, input);
+  }
+  // Bytes written since the last call
+  long Written() {
+    std::fflush(output);
+    long position = lseek(fd, 0, SEEK_CUR);
+    long written = position - last;
+    last = position;
+    return written;
+  }
+
+  int fd{-1};
+  std::FILE* output{nullptr};
+  std::FILE* input{nullptr};
+  SCREEN* screen{nullptr};
+  long last{0};
+};
+
+CountingTerminal& Terminal() {
+  static CountingTerminal terminal;
+  return terminal;
+}
+
+// Bytes written to the terminal per Frame::Flush() of a 40-row process
+// list, with the arg choosing how it changes between refreshes:
+//   0  nothing changes
+//   1  the same rows in the same order; CPU and TIME tick over
+//   2  churn: the rows move up one place and a new process enters at the
+//      bottom, as when the ranking reshuffles
+void BM_FrameFlush(benchmark::State& state) {
+  CountingTerminal& terminal = Terminal();
+  if (terminal.screen == nullptr) {
+    state.SkipWithError("no terminal description for xterm-256color");
+    return;
+  }
+  WINDOW* window = newwin(42, 120, 0, 0);
+  Frame frame(window);
+  int const mode = state.range(0);
+  long tick = 0;
+  auto draw = [&]() {
+    frame.Clear();
+    frame.Print(1, 2, "PID", COLOR_PAIR(2));
+    frame.Print(1, 9, "USER", COLOR_PAIR(2));
+    frame.Print(1, 19, "CPU[%]", COLOR_PAIR(2));
+    frame.Print(1, 26, "RAM[MB]", COLOR_PAIR(2));
+    frame.Print(1, 35, "TIME+", COLOR_PAIR(2));
+    frame.Print(1, 46, "COMMAND", COLOR_PAIR(2));
+    long shift = mode == 2 ? tick : 0;
+    long clock = mode == 0 ? 0 : tick;
+    char time[16];
+    for (int row = 2; row < frame.Rows() - 1; ++row) {
+      long pid = 1000 + 37 * (row + shift);
+      frame.Printf(row, 2, A_NORMAL, "%ld", pid);
+      frame.Printf(row, 9, A_NORMAL, "user%ld", pid % 7);
+      frame.Printf(row, 19, A_NORMAL, "%.2f",
+                   double((pid * 13 + clock) % 10000) / 100);
+      frame.Printf(row, 26, A_NORMAL, "%ld", pid % 4096);
+      Format::ElapsedTime(pid + clock, time, sizeof(time));
+      frame.Print(row, 35, time);
+      frame.Printf(row, 46, A_NORMAL, "/usr/bin/worker --id=%ld", pid);
+    }
+    frame.Flush();
+    doupdate();
+  };
+  draw();
+  terminal.Written();
+  long written = 0;
+  for (auto _ : state) {
+    ++tick;
+    draw();
+    written += terminal.Written();
+  }
+  delwin(window);
+  state.counters["bytes_per_flush"] =
+      benchmark::Counter(written, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FrameFlush)->Arg(0)->Arg(1)->Arg(2);
+
+void BM_ElapsedTime(benchmark::State& state) {
+  long seconds = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Format::ElapsedTime(seconds));
+    seconds = (seconds + 3607) % 360000;
+  }
+}
+BENCHMARK(BM_ElapsedTime);
+
+void BM_ElapsedTimeBuffer(benchmark::State& state) {
+  char buffer[16];
+  long seconds = 0;
+  for (auto _ : state) {
+    Format::ElapsedTime(seconds, buffer, sizeof(buffer));
+    benchmark::DoNotOptimize(buffer);
+    seconds = (seconds + 3607) % 360000;
+  }
+}
+BENCHMARK(BM_ElapsedTimeBuffer);
+
+// Match --name=value
+const char* Flag(const char* argument, const char* name) {
+  std::size_t length = std::strlen(name);
+  if (std::strncmp(argument, name, length) == 0 && argument[length] == '=') {
+    return argument + length + 1;
+  }
+  return nullptr;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  options.root = "/tmp/monitor_bench." + std::to_string(getpid());
+  bool keep = false;
+  bool host = false;
+  for (int i = 1; i < argc; ++i) {
+    const char* value;
+    if ((value = Flag(argv[i], "--pids")) != nullptr) {
+      options.pids = std::atoi(value);
+    } else if ((value = Flag(argv[i], "--threads")) != nullptr) {
+      options.threads = std::atoi(value);
+    } else if ((value = Flag(argv[i], "--fixture")) != nullptr) {
+      options.root = value;
+    } else if (std::strcmp(argv[i], "--keep-fixture") == 0) {
+      keep = true;
+    } else if (std::strcmp(argv[i], "--host") == 0) {
+      host = true;
+    } else {
+      std::fprintf(stderr, "%s: unknown argument %s\n", argv[0], argv[i]);
+      return 1;
+    }
+  }
+
+  if (!host) {
+    if (!ProcFixture::Generate(options)) {
+      std::perror(options.root.c_str());
+      return 1;
+    }
+    ProcFixture::Use(options);
+  }
+  pids = LinuxParser::Pids();
+  benchmark::AddCustomContext("pids", std::to_string(pids.size()));
+  benchmark::AddCustomContext("proc", LinuxParser::kProcDirectory);
+  // Refreshes between reads (listed/other, at this many PIDs) of the
+  // scheduled sources, which the BM_SystemProcesses* figures depend on
+  std::string schedule;
+  for (int i = 0; i < Scheduler::kSources; ++i) {
+    const Scheduler::Policy& policy =
+        Scheduler::Of(static_cast<Scheduler::Source>(i));
+    schedule += (schedule.empty() ? "" : " ") + std::string(policy.name) +
+                "=" + std::to_string(policy.listed) + "/" +
+                std::to_string(Scheduler::Period(
+                    static_cast<Scheduler::Source>(i), pids.size()));
+  }
+  benchmark::AddCustomContext("schedule", schedule);
+  benchmark::AddCustomContext("sizeof(Process)",
+                              std::to_string(sizeof(Process)));
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  if (!host && !keep) {
+    ProcFixture::Remove(options);
+  }
+  if (Terminal().screen != nullptr) {
+    endwin();
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,246 @@
+#include "proc_fixture.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#include "linux_parser.h"
+
+namespace fs = std::filesystem;
+using std::string;
+
+namespace {
+const char* kStates = "SSSSSSSRDI";
+const char* kCommands[] = {"bash", "sshd", "postgres", "java", "node",
+                           "python3", "nginx", "kworker/3:1", "systemd"};
+constexpr int kCommandCount = sizeof(kCommands) / sizeof(kCommands[0]);
+constexpr unsigned long kUptime = 864000;  // ten days, in seconds
+const char* kMeminfo =
+    "MemTotal:       32768000 kB\nMemFree:         8192000 kB\n"
+    "MemAvailable:   20480000 kB\nBuffers:          512000 kB\n"
+    "Cached:         11264000 kB\nSwapCached:        12000 kB\n"
+    "Active:         14336000 kB\nInactive:        7168000 kB\n"
+    "Active(anon):    9216000 kB\nInactive(anon):   512000 kB\n"
+    "Active(file):    5120000 kB\nInactive(file):  6656000 kB\n"
+    "Unevictable:           0 kB\nMlocked:               0 kB\n"
+    "SwapTotal:       8388604 kB\nSwapFree:        8100000 kB\n"
+    "Zswap:                 0 kB\nZswapped:              0 kB\n"
+    "Dirty:              2048 kB\nWriteback:             0 kB\n"
+    "AnonPages:       9700000 kB\nMapped:          1024000 kB\n"
+    "Shmem:            256000 kB\nKReclaimable:     800000 kB\n"
+    "Slab:            1200000 kB\nSReclaimable:     800000 kB\n"
+    "SUnreclaim:       400000 kB\nKernelStack:       24000 kB\n"
+    "PageTables:        96000 kB\nSecPageTables:         0 kB\n"
+    "NFS_Unstable:          0 kB\nBounce:                0 kB\n"
+    "WritebackTmp:          0 kB\nCommitLimit:    24772604 kB\n"
+    "Committed_AS:   30000000 kB\nVmallocTotal:   34359738367 kB\n"
+    "VmallocUsed:      120000 kB\nVmallocChunk:          0 kB\n"
+    "Percpu:            20000 kB\nHardwareCorrupted:     0 kB\n"
+    "AnonHugePages:    200000 kB\nShmemHugePages:        0 kB\n"
+    "ShmemPmdMapped:        0 kB\nFileHugePages:         0 kB\n"
+    "FilePmdMapped:         0 kB\nHugePages_Total:       0\n"
+    "HugePages_Free:        0\nHugePages_Rsvd:        0\n"
+    "HugePages_Surp:        0\nHugepagesize:       2048 kB\n"
+    "Hugetlb:               0 kB\nDirectMap4k:      400000 kB\n"
+    "DirectMap2M:    20000000 kB\nDirectMap1G:    14000000 kB\n";
+
+bool WriteFile(const string& path, const string& contents) {
+  std::FILE* file = std::fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    return false;
+  }
+  bool ok = std::fwrite(contents.data(), 1, contents.size(), file) ==
+            contents.size();
+  return std::fclose(file) == 0 && ok;
+}
+
+string Printf(const char* format, ...) __attribute__((format(printf, 1, 2)));
+string Printf(const char* format, ...) {
+  char buffer[1024];
+  va_list arguments;
+  va_start(arguments, format);
+  int length = std::vsnprintf(buffer, sizeof(buffer), format, arguments);
+  va_end(arguments);
+  return string(buffer, std::min<std::size_t>(length, sizeof(buffer) - 1));
+}
+
+// A command name for `pid`; some contain spaces and parentheses, which the
+// stat parser must cope with
+string Comm(int pid) {
+  string comm = kCommands[pid % kCommandCount];
+  if (pid % 17 == 0) comm = "Web (Content)";
+  if (pid % 23 == 0) comm = "a) b (c";
+  return comm;
+}
+
+string Stat(int pid, int threads, int cores) {
+  unsigned long utime = (pid * 7919UL) % 500000;
+  unsigned long stime = (pid * 104729UL) % 100000;
+  unsigned long starttime =
+      (pid * 31UL) % (kUptime * LinuxParser::ClockTicks());
+  return Printf(
+      "%d (%s) %c %d %d %d 0 -1 4194560 %lu 0 %lu 0 %lu %lu 0 0 20 0 %d 0 "
+      "%lu %lu %lu 18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 %d 0 0 0 "
+      "0 0 0 0 0 0 0 0 0 0\n",
+      pid, Comm(pid).c_str(), kStates[pid % 10], pid / 3, pid, pid,
+      pid * 13UL, pid % 7UL, utime, stime, threads, starttime,
+      (pid % 4096 + 1) * 1048576UL, pid % 50000UL + 100, pid % cores);
+}
+
+string Status(int pid, int uid, int threads) {
+  unsigned long vm_size = (pid % 4096 + 1) * 1024UL;
+  unsigned long vm_rss = (pid % 50000) * 4UL + 400;
+  return Printf(
+      "Name:\t%s\nUmask:\t0022\nState:\t%c (sleeping)\nTgid:\t%d\nNgid:\t0\n"
+      "Pid:\t%d\nPPid:\t%d\nTracerPid:\t0\nUid:\t%d\t%d\t%d\t%d\n"
+      "Gid:\t%d\t%d\t%d\t%d\nFDSize:\t64\nGroups:\t\nVmPeak:\t%lu kB\n"
+      "VmSize:\t%lu kB\nVmLck:\t0 kB\nVmPin:\t0 kB\nVmHWM:\t%lu kB\n"
+      "VmRSS:\t%lu kB\nRssAnon:\t%lu kB\nRssFile:\t0 kB\nRssShmem:\t0 kB\n"
+      "VmData:\t%lu kB\nVmStk:\t132 kB\nVmExe:\t912 kB\nVmLib:\t2120 kB\n"
+      "VmPTE:\t64 kB\nVmSwap:\t0 kB\nThreads:\t%d\n"
+      "SigQ:\t0/62711\nSigPnd:\t0000000000000000\n"
+      "Cpus_allowed_list:\t0-7\nvoluntary_ctxt_switches:\t%d\n"
+      "nonvoluntary_ctxt_switches:\t%d\n",
+      Comm(pid).c_str(), kStates[pid % 10], pid, pid, pid / 3, uid, uid, uid,
+      uid, uid, uid, uid, uid, vm_size, vm_size, vm_rss, vm_rss, vm_rss,
+      vm_size / 2, threads, pid % 1000, pid % 100);
+}
+
+string SmapsRollup(int pid) {
+  unsigned long rss = (pid % 50000) * 4UL + 400;
+  return Printf(
+      "55d0c0000000-7ffd4a5ff000 ---p 00000000 00:00 0 [rollup]\n"
+      "Rss:            %8lu kB\nPss:            %8lu kB\n"
+      "Pss_Anon:       %8lu kB\nPss_File:       %8lu kB\n"
+      "Pss_Shmem:             0 kB\nShared_Clean:   %8lu kB\n"
+      "Shared_Dirty:          0 kB\nPrivate_Clean:  %8lu kB\n"
+      "Private_Dirty:  %8lu kB\nReferenced:     %8lu kB\n"
+      "Anonymous:      %8lu kB\nLazyFree:              0 kB\n"
+      "AnonHugePages:         0 kB\nShmemPmdMapped:        0 kB\n"
+      "FilePmdMapped:         0 kB\nShared_Hugetlb:        0 kB\n"
+      "Private_Hugetlb:       0 kB\nSwap:           %8lu kB\n"
+      "SwapPss:        %8lu kB\nLocked:                0 kB\n",
+      rss, rss * 3 / 4, rss / 2, rss / 4, rss / 2, rss / 8, rss * 3 / 8, rss,
+      rss / 2, pid % 64UL, pid % 64UL);
+}
+
+string Io(int pid) {
+  unsigned long long read = pid * 1048576ULL;
+  unsigned long long write = pid * 524288ULL;
+  return Printf(
+      "rchar: %llu\nwchar: %llu\nsyscr: %d\nsyscw: %d\nread_bytes: %llu\n"
+      "write_bytes: %llu\ncancelled_write_bytes: 0\n",
+      read * 2, write * 2, pid * 10, pid * 5, read, write);
+}
+
+// Two disks with a partition each, and an unused loop device
+const char* kDiskstats =
+    "   7       0 loop0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n"
+    "   8       0 sda 120000 3000 9600000 50000 80000 40000 12800000 90000 0 "
+    "60000 140000 0 0 0 0 2000 1000\n"
+    "   8       1 sda1 119000 3000 9500000 49000 79000 40000 12700000 89000 0 "
+    "59000 138000 0 0 0 0 0 0\n"
+    " 259       0 nvme0n1 500000 0 40000000 100000 300000 0 64000000 200000 0 "
+    "150000 300000 0 0 0 0 0 0\n"
+    " 259       1 nvme0n1p1 499000 0 39900000 99000 299000 0 63900000 199000 0 "
+    "149000 298000 0 0 0 0 0 0\n";
+
+const char* kPressure =
+    "some avg10=1.52 avg60=0.87 avg300=0.31 total=123456789\n"
+    "full avg10=0.40 avg60=0.12 avg300=0.05 total=23456789\n";
+
+string Cmdline(int pid) {
+  string command = Printf("/usr/bin/%s", kCommands[pid % kCommandCount]);
+  command += '\0';
+  command += Printf("--worker=%d", pid);
+  command += '\0';
+  command += "--config=/etc/service.conf";
+  command += '\0';
+  return command;
+}
+
+string SystemStat(const ProcFixture::Options& options) {
+  string stat = Printf("cpu  %lu 0 %lu %lu 0 0 0 0 0 0\n",
+                       4000000UL * options.cores, 900000UL * options.cores,
+                       80000000UL * options.cores);
+  for (int core = 0; core < options.cores; ++core) {
+    stat += Printf("cpu%d 4000000 0 900000 80000000 0 0 0 0 0 0\n", core);
+  }
+  stat += Printf(
+      "intr 0\nctxt 0\nbtime 1700000000\nprocesses %d\nprocs_running %d\n"
+      "procs_blocked 0\n",
+      options.pids * 10, options.pids / 10 + 1);
+  return stat;
+}
+}  // namespace
+
+bool ProcFixture::Generate(const Options& options) {
+  fs::path proc = fs::path(options.root) / "proc";
+  fs::path etc = fs::path(options.root) / "etc";
+  std::error_code error;
+  fs::remove_all(options.root, error);
+  fs::create_directories(proc, error);
+  fs::create_directories(proc / "pressure", error);
+  fs::create_directories(etc, error);
+  if (error) {
+    return false;
+  }
+
+  string passwd = "root:x:0:0:root:/root:/bin/bash\n";
+  for (int user = 1; user < options.users; ++user) {
+    passwd += Printf("user%d:x:%d:%d::/home/user%d:/bin/sh\n", user,
+                     999 + user, 999 + user, user);
+  }
+  bool ok = WriteFile((etc / "passwd").string(), passwd) &&
+            WriteFile((proc / "stat").string(), SystemStat(options)) &&
+            WriteFile((proc / "meminfo").string(), kMeminfo) &&
+            WriteFile((proc / "diskstats").string(), kDiskstats) &&
+            WriteFile((proc / "loadavg").string(),
+                      Printf("2.15 1.80 1.52 %d/%d 99999\n",
+                             options.pids / 10 + 1,
+                             options.pids * options.threads)) &&
+            WriteFile((proc / "uptime").string(),
+                      Printf("%lu.00 %lu.00\n", kUptime, kUptime * 6)) &&
+            WriteFile((proc / "version").string(),
+                      "Linux version 6.1.0-fixture (bench@localhost) #1 SMP\n");
+
+  for (const char* resource : {"cpu", "memory", "io"}) {
+    ok = ok && WriteFile((proc / "pressure" / resource).string(), kPressure);
+  }
+
+  for (int pid = 1; ok && pid <= options.pids; ++pid) {
+    int uid = pid % options.users == 0 ? 0 : 999 + pid % options.users;
+    fs::path directory = proc / std::to_string(pid);
+    fs::create_directories(directory / "task", error);
+    string stat = Stat(pid, options.threads, options.cores);
+    ok = !error && WriteFile((directory / "stat").string(), stat) &&
+         WriteFile((directory / "status").string(),
+                   Status(pid, uid, options.threads)) &&
+         WriteFile((directory / "cmdline").string(), Cmdline(pid)) &&
+         WriteFile((directory / "smaps_rollup").string(), SmapsRollup(pid)) &&
+         WriteFile((directory / "io").string(), Io(pid));
+    // The first thread is the process itself; the others get TIDs above
+    // every PID
+    for (int thread = 0; ok && thread < options.threads; ++thread) {
+      int tid =
+          thread == 0 ? pid : options.pids + pid * options.threads + thread;
+      fs::path task = directory / "task" / std::to_string(tid);
+      fs::create_directories(task, error);
+      ok = !error && WriteFile((task / "stat").string(), stat);
+    }
+  }
+  return ok;
+}
+
+void ProcFixture::Use(const Options& options) {
+  LinuxParser::kProcDirectory = (fs::path(options.root) / "proc/").string();
+  LinuxParser::kPasswordPath = (fs::path(options.root) / "etc/passwd").string();
+}
+
+void ProcFixture::Remove(const Options& options) {
+  std::error_code error;
+  fs::remove_all(options.root, error);
+}
@@ -0,0 +1,29 @@
+#ifndef PROC_FIXTURE_H
+#define PROC_FIXTURE_H
+
+#include <string>
+
+/*
+A synthetic /proc tree for benchmarks.
+Generate() writes <root>/proc with the system files the monitor reads
+(stat, meminfo, uptime, version) and `pids` process directories with stat,
+status, cmdline, smaps_rollup and `threads` task entries each, plus an
+<root>/etc/passwd naming the UIDs used. Contents depend only on the
+arguments, so runs are reproducible on any Linux box.
+*/
+namespace ProcFixture {
+struct Options {
+  std::string root;
+  int pids{2000};
+  int threads{4};
+  int cores{8};
+  int users{50};
+};
+
+bool Generate(const Options& options);
+// Point LinuxParser at a generated tree; call before the first read
+void Use(const Options& options);
+void Remove(const Options& options);
+};  // namespace ProcFixture
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef CGROUP_STATS_H
+#define CGROUP_STATS_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "linux_parser.h"
+#include "process.h"
+
+// One cgroup and the processes seen in it in the last refresh
+struct CgroupUsage {
+  std::string path;  // relative to the cgroup v2 root
+  int processes{0};
+  float cpu{0.0f};  // CPUs' worth used over the last interval
+  // memory.current, or the RSS of its processes where the memory
+  // controller is not enabled
+  unsigned long long memory_kb{0};
+  bool has_io{false};  // io.stat is only there with the io controller
+  float read_bps{0.0f};
+  float write_bps{0.0f};
+};
+
+/*
+Rolls processes up by cgroup v2. CPU, memory and I/O come from each
+cgroup's own cpu.stat, memory.current and io.stat, which the kernel keeps
+for all of its tasks, so a refresh costs three small reads per cgroup
+instead of a sum over every PID. Only cgroups holding at least one process
+are read. As in the kernel, a cgroup's counters include those of its
+descendants, so the root cgroup ("/") accounts for the whole system.
+Files are opened for each read rather than kept open: a node can have
+thousands of cgroups, and three descriptors each would run into the file
+limit.
+*/
+class CgroupStats {
+ public:
+  CgroupStats();
+  // Count a process toward its cgroup in this refresh
+  void Add(const Process& process);
+  // Read the cgroups added since the last call and measure each against
+  // its previous sample. A cgroup seen for the first time shows no CPU or
+  // I/O until the next refresh; one with no processes left is forgotten.
+  void Update(float elapsed_seconds);
+  std::vector<CgroupUsage>& Usage();  // In no particular order
+
+ private:
+  struct Tracked {
+    PooledString path;  // keeps the key's ID bound to this path
+    CgroupUsage usage;
+    LinuxParser::CgroupCounters previous;
+    bool sampled{false};
+    unsigned long long rss_kb{0};
+    unsigned long generation{0};
+  };
+
+  std::string root_;
+  std::string directory_;  // root_ + path, rebuilt for each read
+  // Keyed by the interned path's ID, so adding a process hashes no text
+  std::unordered_map<std::uint32_t, Tracked> groups_;
+  std::vector<CgroupUsage> usage_;
+  unsigned long generation_{1};
+};
+
+#endif
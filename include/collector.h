@@ -0,0 +1,79 @@
+#ifndef COLLECTOR_H
+#define COLLECTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "history.h"
+#include "instrument.h"
+#include "pressure_trigger.h"
+#include "snapshot.h"
+#include "system.h"
+#include "triple_buffer.h"
+
+/*
+Samples System on a thread of its own at an interval that can be changed
+while it runs, and publishes each result as a Snapshot. A slow /proc read
+only delays the next snapshot; the display keeps drawing (and reading keys)
+from the last one.
+*/
+class Collector {
+ public:
+  // `interval` is clamped as by Interval()
+  Collector(System& system, int n, std::chrono::milliseconds interval);
+  ~Collector();
+  Collector(const Collector&) = delete;
+  Collector& operator=(const Collector&) = delete;
+
+  // Append every snapshot to `history` as well (it must outlive the
+  // collector)
+  void Record(History* history);
+  // Also wake up when `trigger` fires, and sample every kPressureInterval
+  // instead of every interval until pressure has stayed below the trigger
+  // threshold for two trigger windows (`trigger` must outlive the
+  // collector)
+  static constexpr std::chrono::milliseconds kPressureInterval{250};
+  void WatchPressure(PressureTrigger* trigger);
+  // Change the interval from any thread, clamped to kMinInterval ..
+  // kMaxInterval. It applies to the tick being waited for.
+  static constexpr std::chrono::milliseconds kMinInterval{100};
+  static constexpr std::chrono::milliseconds kMaxInterval{60000};
+  void Interval(std::chrono::milliseconds interval);
+  std::chrono::milliseconds Interval() const;
+  void Start();
+  void Stop();
+  // Fill `snapshot` on the calling thread, for users that do not need the
+  // background thread. Not to be mixed with Start().
+  void CollectNow(Snapshot& snapshot);
+  // Block until the next tick is due, for callers of CollectNow() (see
+  // Run())
+  void WaitForTick();
+  // Make the newest snapshot current; false if nothing new was published
+  bool Update();
+  Snapshot& Latest();  // Only valid on the reading thread
+  // Render time of the previous frame, reported in the next snapshot
+  void ReportRender(double milliseconds);
+
+ private:
+  void Run();
+  void Collect(Snapshot& snapshot);
+
+  System& system_;
+  int n_;
+  std::atomic<std::chrono::milliseconds> interval_;
+  TripleBuffer<Snapshot> buffer_;
+  std::thread thread_;
+  std::atomic<bool> stop_{false};
+  std::atomic<double> render_{0.0};
+  unsigned long sequence_{0};
+  History* history_{nullptr};
+  PressureTrigger* trigger_{nullptr};
+  std::chrono::steady_clock::time_point deadline_{
+      std::chrono::steady_clock::now()};
+  std::chrono::steady_clock::time_point pressure_until_{};
+  Instrument::Counters counters_;  // Totals at the previous snapshot
+  bool counted_{false};
+};
+
+#endif
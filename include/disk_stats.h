@@ -0,0 +1,29 @@
+#ifndef DISK_STATS_H
+#define DISK_STATS_H
+
+#include <vector>
+
+#include "system_snapshot.h"
+
+// Throughput of one disk over the last sampling interval
+struct DiskRate {
+  char name[32]{};
+  float read_bps{0.0f};     // bytes per second
+  float write_bps{0.0f};
+  float utilization{0.0f};  // share of the interval with I/O in flight (0..1)
+};
+
+class DiskStats {
+ public:
+  void Update(const SystemSnapshot& snapshot);  // Take a new sample
+  // Whole disks in /proc/diskstats order. A disk that just appeared shows
+  // no throughput until the next sample.
+  const std::vector<DiskRate>& Rates() const;
+
+ private:
+  std::vector<DiskCounters> previous_;
+  double previous_uptime_{0.0};
+  std::vector<DiskRate> rates_;
+};
+
+#endif
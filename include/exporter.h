@@ -0,0 +1,109 @@
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "history.h"
+#include "pressure_trigger.h"
+#include "snapshot.h"
+#include "system.h"
+
+/*
+Streams snapshots to stdout, a file or a Unix socket, one record per tick,
+for running the monitor headless as a node agent.
+Records are encoded straight from the Snapshot into a buffer that is reused
+from tick to tick, so a steady stream does not allocate.
+Run() keeps the monitor within a share of one core (CpuBudget()): when the
+CPU time of a tick, averaged over the last few, would exceed that share of
+the interval, the interval is widened until it does not, up to
+Collector::kMaxInterval, and narrowed back as the cost drops. Pressure
+trigger ticks are not held back. Sources no record carries (smaps_rollup,
+the thread view) are not read.
+
+JSON Lines: one object per line,
+  {"seq":..,"ts":..,"cpu":..,"cores":[..],"mem":..,"cache":..,"swap":..,
+   "disks":[{"name":..,"read_bps":..,"write_bps":..,"util":..}],
+   "load":[1,5,15],"psi":{"cpu":{"some":..,"full":..},"mem":{..},"io":{..}},
+   "procs":..,"running":..,
+   "uptime":..,"top":[{"pid":..,"ppid":..,"user":..,"cpu":..,"ram_mb":..,
+   "read_bps":..,"write_bps":..,"uptime":..,"cmd":..}],
+   "cgroups":[{"path":..,"procs":..,"cpu":..,"mem_mb":..,"read_bps":..,
+   "write_bps":..}],
+   "exited":[{"pid":..,"cmd":..,"jiffies":..}],
+   "self":{"syscalls":..,"bytes_read":..,"allocs":..,
+           "collect":{"wall_ns":..,"cpu_ns":..},"sort":{..},"render":{..},
+           "export":{..}}}
+  "self" (the monitor's own cost, see instrument.h) is only present while
+  instrumentation is enabled, "cgroups" only with the group view on,
+  "psi" (avg10 stall percentages) only where
+  the kernel provides /proc/pressure, and "read_bps"/"write_bps" of a
+  process only where its /proc/[pid]/io could be read.
+
+Binary (native byte order):
+  u32 record length (excluding itself), u32 kBinaryMagic, u64 seq, i64 ts,
+  f32 cpu, f32 mem, f32 cache, f32 swap, i32 procs, i32 running, i64 uptime,
+  u32 cores, f32[cores],
+  u32 disks, disks x {str name, f32 read_bps, f32 write_bps, f32 util},
+  f32 load[3], u32 psi (0 or 1), psi x {f32 some, f32 full for cpu, memory
+                                        and io},
+  u32 top, top x {i32 pid, i32 ppid, f32 cpu, u64 ram_mb, f32 read_bps,
+                  f32 write_bps, i64 uptime, str user, str cmd},
+  u32 cgroups, cgroups x {str path, i32 procs, f32 cpu, u64 mem_mb,
+                          f32 read_bps, f32 write_bps},
+  u32 exited, exited x {i32 pid, u64 jiffies, str cmd},
+  u32 self (0 or 1), self x {u64 syscalls, u64 bytes_read, u64 allocs,
+                             u64 wall_ns, u64 cpu_ns for collect, sort,
+                             render and export}
+  where str is a u16 length followed by that many bytes.
+ram_mb is the resident set size. read_bps and write_bps are bytes per
+second; in binary records they are -1 where the process's io is unknown.
+*/
+class Exporter {
+ public:
+  enum class Encoding { kJsonLines, kBinary };
+  static constexpr std::uint32_t kBinaryMagic = 0x4d4f4e36;  // "MON6"
+
+  explicit Exporter(Encoding encoding);
+  ~Exporter();
+  Exporter(const Exporter&) = delete;
+  Exporter& operator=(const Exporter&) = delete;
+
+  // "-" is stdout, "unix:<path>" a Unix stream socket and anything else a
+  // file, appended to
+  bool Open(const std::string& target);
+  bool Write(const Snapshot& snapshot);
+  // Share of one core Run() may use; 0 for no limit
+  static constexpr double kCpuBudget = 0.01;
+  void CpuBudget(double share);
+  // Collect and export every `interval` until the output fails, recording
+  // each tick in `history` if one is given and sampling faster while
+  // `trigger` reports pressure (see Collector::WatchPressure)
+  int Run(System& system, int n, std::chrono::milliseconds interval,
+          History* history = nullptr, PressureTrigger* trigger = nullptr);
+
+ private:
+  void EncodeJson(const Snapshot& snapshot);
+  void EncodeBinary(const Snapshot& snapshot);
+  char* Reserve(std::size_t size);
+  void Append(std::string_view text);
+  void AppendString(std::string_view text);  // JSON string, quoted
+  template <typename T>
+  void AppendNumber(T value);
+  template <typename T>
+  void AppendRaw(T value);
+  void AppendRawString(std::string_view text);
+
+  Encoding encoding_;
+  double cpu_budget_{kCpuBudget};
+  int fd_{-1};
+  bool owns_fd_{false};
+  std::vector<char> buffer_;
+  std::size_t size_{0};
+};
+
+#endif
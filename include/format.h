@@ -1,10 +1,15 @@
 #ifndef FORMAT_H
 #define FORMAT_H
 
+#include <cstddef>
 #include <string>
 
 namespace Format {
 std::string ElapsedTime(long times);  // TODO: See src/format.cpp
+// Same as above, written into `buffer` without allocating
+void ElapsedTime(long seconds, char* buffer, std::size_t size);
+// A byte count in at most five characters, e.g. "512", "12.3K", "4.5G"
+void Bytes(double bytes, char* buffer, std::size_t size);
 };                                    // namespace Format
 
 #endif
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <curses.h>
+
+#include <vector>
+
+/*
+Cell model of an ncurses window.
+Each refresh draws into the current frame; Flush() compares it with the
+frame drawn last time and only hands the cells that changed to ncurses,
+then queues the window with wnoutrefresh() so that one doupdate() writes
+every window at once. The border is drawn once and never touched again.
+*/
+class Frame {
+ public:
+  explicit Frame(WINDOW* window);
+
+  int Rows() const;
+  int Columns() const;
+  void Clear();  // Blank the interior before drawing a new frame
+  void ClearRow(int row);
+  void Put(int row, int column, chtype cell);
+  void Print(int row, int column, const char* text,
+             chtype attributes = A_NORMAL);
+  void Printf(int row, int column, chtype attributes, const char* format, ...)
+      __attribute__((format(printf, 5, 6)));
+  void Flush();
+
+ private:
+  bool Inside(int row, int column) const;
+
+  WINDOW* window_;
+  int rows_;
+  int columns_;
+  std::vector<chtype> current_;
+  std::vector<chtype> previous_;
+  char buffer_[512];
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "snapshot.h"
+
+/*
+Fixed-size on-disk ring buffer of per-tick records, mapped into memory.
+Appending copies one record into the mapping and bumps the record count:
+no system call, the page cache writes the data back on its own. Once the
+file is full the oldest record is overwritten.
+
+Records are fixed size. They hold the system-wide figures the display
+shows, except the per-core strip, for up to kDisks disks. Per-process
+fields are columnar: each is an array over the top kTop processes. CPU
+time is stored as the jiffies a process used during the tick (a delta of
+its utime+stime counter) together with the tick length, instead of as a
+rounded percentage.
+
+A replay may read the file while another monitor appends to it, and once
+the ring is full the record being overwritten is the oldest one, which
+the reader may be copying. Each record carries a stamp, odd while it is
+being written (a seqlock): readers copy the record and retry when the
+stamp was odd or changed, so they see either the old record or the new
+one, never a mix.
+*/
+class History {
+ public:
+  static constexpr int kTop = 16;
+  static constexpr int kUserLength = 16;
+  static constexpr int kCommandLength = 64;
+  static constexpr int kDisks = 8;
+
+  struct Record {
+    // 2 * position + 1 while being written, 2 * position + 2 once written;
+    // only accessed atomically
+    std::uint64_t stamp;
+    std::uint64_t sequence;
+    std::int64_t timestamp_ms;
+    std::uint32_t interval_ms;  // since the previous tick
+    float cpu;
+    CpuBreakdown breakdown;
+    float memory;
+    float cache;
+    float swap;
+    std::uint32_t disk_count;
+    DiskRate disks[kDisks];
+    float load[3];  // 1, 5 and 15 minutes
+    std::int32_t runnable;
+    std::int32_t entities;
+    std::uint32_t has_pressure;
+    // cpu, memory and io: some avg10, avg60 and avg300, then full avg10
+    float pressure[3][4];
+    std::int32_t total_processes;
+    std::int32_t running_processes;
+    std::int64_t uptime;
+    std::uint32_t count;  // entries used in the columns below
+    std::int32_t pid[kTop];
+    std::uint32_t jiffies[kTop];  // CPU time used during the interval
+    std::uint32_t ram_mb[kTop];
+    std::uint32_t start[kTop];    // seconds after boot
+    char user[kTop][kUserLength];
+    char command[kTop][kCommandLength];
+  };
+
+  History() = default;
+  ~History();
+  History(const History&) = delete;
+  History& operator=(const History&) = delete;
+
+  // Open for appending, creating the file (or starting it over when its
+  // layout differs) with room for `capacity` records
+  bool Create(const std::string& path, std::size_t capacity);
+  // Open an existing file read-only, for replay
+  bool Open(const std::string& path);
+
+  void Append(const Snapshot& snapshot);
+  std::size_t Size() const;  // Records available, at most the capacity
+  // Rebuild record `index` (0 is the oldest) as a Snapshot
+  void Load(std::size_t index, Snapshot& snapshot) const;
+  // A consistent copy of record `index`
+  Record At(std::size_t index) const;
+
+ private:
+  // What has to match for an existing file to be appended to
+  struct Layout {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint64_t capacity;
+    std::int32_t clock_ticks;
+    std::int32_t top;
+  };
+  struct Header {
+    Layout layout;
+    std::atomic<std::uint64_t> written;  // records appended so far
+  };
+  static constexpr std::size_t kHeaderSize = 4096;
+
+  bool Map(int fd, std::size_t size, bool writable);
+  Record* Slot(std::uint64_t position) const;
+
+  Header* header_{nullptr};
+  void* mapping_{nullptr};
+  std::size_t size_{0};
+  std::int64_t last_timestamp_{0};
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <time.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+What the monitor itself costs: syscalls issued, bytes read from /proc, heap
+allocations, and wall and CPU time per stage of a tick.
+Each thread counts into its own counters, so counting takes no locks and
+shares no cache lines; Totals() sums them. Counting only happens while
+SetEnabled(true) is in effect.
+Building with -DMONITOR_INSTRUMENT=0 compiles all of it out: the INSTRUMENT_*
+macros expand to nothing and operator new is left alone.
+*/
+#ifndef MONITOR_INSTRUMENT
+#define MONITOR_INSTRUMENT 1
+#endif
+
+namespace Instrument {
+constexpr bool kCompiled = MONITOR_INSTRUMENT;
+
+enum Stage { kCollect = 0, kSort, kRender, kExport, kStages };
+const char* StageName(Stage stage);
+
+struct Counters {
+  std::uint64_t syscalls{0};
+  std::uint64_t bytes_read{0};
+  std::uint64_t allocations{0};
+  std::uint64_t wall_ns[kStages]{};
+  // Summed over every thread that worked on the stage
+  std::uint64_t cpu_ns[kStages]{};
+
+  Counters operator-(const Counters& other) const;
+};
+
+void SetEnabled(bool enabled);
+bool Enabled();
+Counters Totals();  // Everything counted so far, by all threads
+
+#if MONITOR_INSTRUMENT
+void CountSyscalls(unsigned count);
+void CountRead(std::size_t bytes);
+
+// Adds the time between construction and destruction to `stage`. Nested
+// timers for a stage already being timed on this thread do nothing, so a
+// worker body can be timed whether or not the caller runs it.
+class StageTimer {
+ public:
+  // `wall` is false for work running in parallel with the timed caller,
+  // which should only add CPU time
+  explicit StageTimer(Stage stage, bool wall = true);
+  ~StageTimer();
+  StageTimer(const StageTimer&) = delete;
+  StageTimer& operator=(const StageTimer&) = delete;
+
+ private:
+  Stage stage_;
+  bool active_;
+  bool wall_;
+  timespec wall_start_;
+  timespec cpu_start_;
+};
+#endif
+};  // namespace Instrument
+
+#if MONITOR_INSTRUMENT
+#define INSTRUMENT_SYSCALLS(count) Instrument::CountSyscalls(count)
+#define INSTRUMENT_READ(bytes) Instrument::CountRead(bytes)
+#define INSTRUMENT_STAGE(stage) \
+  Instrument::StageTimer instrument_stage_timer_(Instrument::stage)
+#define INSTRUMENT_STAGE_CPU(stage) \
+  Instrument::StageTimer instrument_stage_timer_(Instrument::stage, false)
+#else
+#define INSTRUMENT_SYSCALLS(count) ((void)0)
+#define INSTRUMENT_READ(bytes) ((void)0)
+#define INSTRUMENT_STAGE(stage) ((void)0)
+#define INSTRUMENT_STAGE_CPU(stage) ((void)0)
+#endif
+
+#endif
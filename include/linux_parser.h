@@ -1,22 +1,40 @@
 #ifndef SYSTEM_PARSER_H
 #define SYSTEM_PARSER_H
 
+#include <cstddef>
 #include <fstream>
 #include <regex>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace LinuxParser {
 // Paths
-const std::string kProcDirectory{"/proc/"};
+// The /proc root and password file can be pointed at a fixture tree (see
+// bench/). Set them before the first read: the /proc directory is opened
+// once.
+inline std::string kProcDirectory{"/proc/"};
 const std::string kCmdlineFilename{"/cmdline"};
 const std::string kCpuinfoFilename{"/cpuinfo"};
 const std::string kStatusFilename{"/status"};
 const std::string kStatFilename{"/stat"};
+const std::string kTaskDirectory{"/task"};
+const std::string kSmapsRollupFilename{"/smaps_rollup"};
+const std::string kIoFilename{"/io"};
+const std::string kCgroupFilename{"/cgroup"};
+const std::string kMountsFilename{"/self/mounts"};
+const std::string kDiskstatsFilename{"/diskstats"};
 const std::string kUptimeFilename{"/uptime"};
 const std::string kMeminfoFilename{"/meminfo"};
+const std::string kLoadavgFilename{"/loadavg"};
+// Pressure stall information: cpu, memory and io files
+const std::string kPressureDirectory{"/pressure"};
 const std::string kVersionFilename{"/version"};
 const std::string kOSPath{"/etc/os-release"};
-const std::string kPasswordPath{"/etc/passwd"};
+inline std::string kPasswordPath{"/etc/passwd"};
+// Mount point of the cgroup v2 hierarchy; found in /proc/self/mounts when
+// left empty
+inline std::string kCgroupDirectory{};
 
 // key words
 const std::string filterProcesses("processes");
@@ -26,6 +44,47 @@ const std::string filterProcMem("VmSize:");
 const std::string filterOperatingSystem("PRETTY_NAME");
 
 // System
+// /proc/meminfo, in kB except for the HugePages_ counts
+struct MemInfo {
+  long mem_total{0};
+  long mem_free{0};
+  long mem_available{-1};  // -1 on kernels before 3.14
+  long buffers{0};
+  long cached{0};
+  long swap_cached{0};
+  long active{0};
+  long inactive{0};
+  long swap_total{0};
+  long swap_free{0};
+  long dirty{0};
+  long writeback{0};
+  long anon_pages{0};
+  long mapped{0};
+  long shmem{0};
+  long slab{0};
+  long s_reclaimable{0};
+  long s_unreclaim{0};
+  long kernel_stack{0};
+  long page_tables{0};
+  long commit_limit{0};
+  long committed_as{0};
+  long huge_pages_total{0};
+  long huge_pages_free{0};
+  long huge_page_size{0};
+
+  // Page cache and reclaimable slab, less shared memory (which cannot be
+  // dropped), as free(1) and htop count it
+  long CacheKilobytes() const;
+  // Memory not available for new allocations without swapping
+  long UsedKilobytes() const;
+  float Used() const;   // Shares of mem_total
+  float Cache() const;
+  float Swap() const;   // Share of swap_total in use
+};
+// Fill `info` from the contents of /proc/meminfo in one pass. Fields the
+// kernel does not report keep their previous values.
+void ParseMemInfo(std::string_view contents, MemInfo& info);
+bool ReadMemInfo(MemInfo& info);
 float MemoryUtilization();
 long UpTime();
 std::vector<int> Pids();
@@ -54,6 +113,82 @@ long ActiveJiffies(int pid);
 long IdleJiffies();
 
 // Processes
+// Fields of /proc/[pid]/stat (see proc(5)), filled by a single read
+struct ProcStatSnapshot {
+  int pid{0};
+  char comm[17]{};  // TASK_COMM_LEN + '\0'
+  char state{'?'};
+  int ppid{0};
+  int pgrp{0};
+  int session{0};
+  unsigned long minflt{0};
+  unsigned long majflt{0};
+  unsigned long long utime{0};   // jiffies
+  unsigned long long stime{0};   // jiffies
+  long long cutime{0};           // jiffies
+  long long cstime{0};           // jiffies
+  long priority{0};
+  long nice{0};
+  long num_threads{0};
+  unsigned long long starttime{0};  // jiffies after system boot
+  unsigned long vsize{0};           // bytes
+  long rss{0};                      // pages
+  int processor{0};
+};
+bool ReadProcStat(int pid, ProcStatSnapshot& snapshot);
+// The same fields for one thread, from /proc/[pid]/task/[tid]/stat
+bool ReadTaskStat(int pid, int tid, ProcStatSnapshot& snapshot);
+bool ParseProcStat(const char* data, std::size_t size,
+                   ProcStatSnapshot& snapshot);
+long ClockTicks();
+
+// Fields of /proc/[pid]/status, filled by a single read
+struct ProcStatusSnapshot {
+  int uid{-1};         // real UID
+  long vm_size_kb{0};  // VmSize
+  long vm_rss_kb{0};   // VmRSS
+};
+bool ReadProcStatus(int pid, ProcStatusSnapshot& snapshot);
+
+// Totals of /proc/[pid]/smaps_rollup. Reading it walks every mapping of the
+// process, so it is much more expensive than stat; it also needs ptrace
+// read access, so for other users' processes it fails with EACCES unless
+// running as root.
+struct SmapsRollupSnapshot {
+  long rss_kb{0};
+  long pss_kb{0};   // proportional: shared pages split between their users
+  long uss_kb{0};   // unique: Private_Clean + Private_Dirty
+  long swap_kb{0};
+};
+// On failure errno tells an exited process from a denied one
+bool ReadSmapsRollup(int pid, SmapsRollupSnapshot& snapshot);
+
+// Cumulative I/O of /proc/[pid]/io. Like smaps_rollup it needs ptrace read
+// access; errno is EACCES when that is missing.
+struct ProcIoSnapshot {
+  unsigned long long read_bytes{0};   // fetched from storage
+  unsigned long long write_bytes{0};  // sent to storage
+};
+bool ReadProcIo(int pid, ProcIoSnapshot& snapshot);
+
+// Path of the cgroup v2 ("0::" line of /proc/[pid]/cgroup) a process is
+// in, relative to CgroupRoot(); empty without one
+std::string Cgroup(int pid);
+std::string CgroupRoot();  // Resolved once
+// Usage counters of one cgroup v2 directory. Files of controllers that are
+// not enabled for the cgroup are missing; their counters are left at -1.
+struct CgroupCounters {
+  long long usage_usec{-1};      // cpu.stat, CPU time of every task in it
+  long long memory_bytes{-1};    // memory.current
+  long long read_bytes{-1};      // io.stat, summed over devices
+  long long write_bytes{-1};
+};
+bool ReadCgroup(const std::string& directory, CgroupCounters& counters);
+long PageSize();
+
+// Thread IDs of a process, at most `limit` of them
+std::vector<int> Tids(int pid, std::size_t limit);
+
 std::string Command(int pid);
 std::string Ram(int pid);
 std::string Uid(int pid);
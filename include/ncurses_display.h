@@ -3,14 +3,41 @@
 
 #include <curses.h>
 
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "frame.h"
+#include "history.h"
+#include "pressure_trigger.h"
 #include "process.h"
+#include "snapshot.h"
 #include "system.h"
 
 namespace NCursesDisplay {
-void Display(System& system, int n = 10);
-void DisplaySystem(System& system, WINDOW* window);
-void DisplayProcesses(std::vector<Process>& processes, WINDOW* window, int n);
-std::string ProgressBar(float percent);
+// Draw snapshots from a collector thread sampling every `interval`, until
+// 'q' is pressed. Every snapshot is also appended to `history`, if given.
+// With a `trigger`, sampling speeds up while it reports pressure.
+void Display(System& system, int n = 10,
+             std::chrono::milliseconds interval = std::chrono::seconds(1),
+             History* history = nullptr, PressureTrigger* trigger = nullptr);
+// Play back a recorded history file
+void Replay(History& history, int n = 10);
+void DisplaySystem(Snapshot& snapshot, Frame& frame);
+// The header of the column the list is sorted by is underlined. With
+// `tree`, rows are indented by depth and show subtree totals. The memory
+// detail and I/O columns are left out of narrow windows.
+void DisplayProcesses(std::vector<Process>& processes, Frame& frame, int n,
+                      System::SortOrder sort = System::SortOrder::kCpu,
+                      bool tree = false);
+// Same, for the cgroup view
+void DisplayCgroups(const std::vector<CgroupUsage>& cgroups, Frame& frame,
+                    int n, System::SortOrder sort = System::SortOrder::kCpu);
+void ProgressBar(Frame& frame, int row, int column, float percent);
+int HeatStripRows(std::size_t cores, int columns);
+void HeatStrip(const std::vector<float>& cores, Frame& frame, int& row);
+void DisplayPressure(const Snapshot& snapshot, Frame& frame, int row);
+void DisplayDisks(const std::vector<DiskRate>& disks, Frame& frame, int row);
 };  // namespace NCursesDisplay
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,40 @@
+#ifndef PRESSURE_TRIGGER_H
+#define PRESSURE_TRIGGER_H
+
+#include <poll.h>
+
+#include <chrono>
+#include <vector>
+
+/*
+PSI triggers on /proc/pressure/{cpu,memory,io}: after "some <stall>
+<window>" is written to one of those files, the kernel wakes poll() on it
+with POLLPRI whenever tasks were stalled on the resource for longer than
+`stall` within a `window`, at most once per window.
+Unprivileged processes may only use windows that are a multiple of two
+seconds (kernel 6.5 and later; earlier kernels need CAP_SYS_RESOURCE), so
+Arm() falls back to such a window when the one asked for is refused.
+*/
+class PressureTrigger {
+ public:
+  PressureTrigger() = default;
+  ~PressureTrigger();
+  PressureTrigger(const PressureTrigger&) = delete;
+  PressureTrigger& operator=(const PressureTrigger&) = delete;
+
+  // Arm a trigger on every resource that allows one; false if none did
+  bool Arm(std::chrono::microseconds stall, std::chrono::microseconds window);
+  bool Armed() const;
+  std::chrono::microseconds Window() const;  // as finally armed
+  // Wait until a trigger fires (true) or `timeout` passes (false)
+  bool Wait(std::chrono::milliseconds timeout);
+
+ private:
+  bool ArmOne(const char* resource, std::chrono::microseconds stall,
+              std::chrono::microseconds window);
+
+  std::vector<pollfd> fds_;
+  std::chrono::microseconds window_{0};
+};
+
+#endif
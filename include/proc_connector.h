@@ -0,0 +1,57 @@
+#ifndef PROC_CONNECTOR_H
+#define PROC_CONNECTOR_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "linux_parser.h"
+
+/*
+Process lifecycle events from the kernel proc connector (a NETLINK_CONNECTOR
+socket subscribed to PROC_EVENT_FORK/EXEC/EXIT).
+Events are received on a background thread as they happen. On exit the
+thread reads /proc/[pid]/stat right away, so that processes living only a
+few milliseconds can still be reported with their final CPU totals. That
+read is best-effort: the kernel sends the event while the task is exiting,
+and the parent may reap it before the read. Such events come without a
+stat (has_stat is false).
+Subscribing needs CAP_NET_ADMIN; when Start() fails callers have to fall
+back to scanning /proc.
+*/
+class ProcConnector {
+ public:
+  struct Event {
+    enum Type { kFork, kExec, kExit } type;
+    int pid;
+    bool has_stat;  // stat was captured (exit events only; best-effort)
+    LinuxParser::ProcStatSnapshot stat;
+  };
+
+  ProcConnector() = default;
+  ~ProcConnector();
+  ProcConnector(const ProcConnector&) = delete;
+  ProcConnector& operator=(const ProcConnector&) = delete;
+
+  bool Start();  // Subscribe and start listening
+  bool Running() const;
+  // Move the events received since the last call into `events`. Returns
+  // false if events were lost (socket overrun or failure), in which case
+  // the caller's view of the process list can no longer be trusted.
+  bool Drain(std::vector<Event>& events);
+
+ private:
+  void Listen();
+  void Handle(const char* buffer, long size);
+
+  int socket_{-1};
+  std::thread listener_;
+  std::atomic<bool> stop_{false};
+  std::atomic<bool> running_{false};
+  std::mutex mutex_;
+  std::vector<Event> pending_;
+  bool lost_{false};
+};
+
+#endif
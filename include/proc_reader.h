@@ -0,0 +1,88 @@
+#ifndef PROC_READER_H
+#define PROC_READER_H
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+Allocation free access to /proc.
+Files are opened with openat() relative to a directory descriptor that is
+opened once, paths are formatted on the stack and contents are read into a
+buffer owned by the calling thread. A returned view stays valid until the
+same thread reads another file.
+*/
+namespace ProcReader {
+// Read <proc>/<name>, e.g. Read("/meminfo")
+bool Read(const std::string& name, std::string_view& contents);
+// Read <proc>/<pid>/<name>, e.g. Read(42, "/stat")
+bool Read(int pid, const std::string& name, std::string_view& contents);
+// Read <proc>/<pid>/task/<tid>/<name>
+bool Read(int pid, int tid, const std::string& name,
+          std::string_view& contents);
+// Append the numeric subdirectories (PIDs, TIDs) of the open directory `fd`,
+// from its current offset, stopping once `ids` holds `limit` entries
+bool ReadIds(int fd, std::vector<int>& ids,
+             std::size_t limit = std::size_t(-1));
+// Same for <proc>/<pid>/<name>, e.g. ListIds(42, "/task", tids)
+bool ListIds(int pid, const std::string& name, std::vector<int>& ids,
+             std::size_t limit = std::size_t(-1));
+// Read a file outside /proc, e.g. "/etc/passwd"
+bool ReadPath(const std::string& path, std::string_view& contents);
+
+// Return the line following `key` (with the key removed), or an empty view.
+// The key must match from the beginning of a line.
+std::string_view FindValue(std::string_view contents, std::string_view key);
+
+// Cursor over whitespace separated fields. Numbers are parsed in place with
+// std::from_chars; fields that are missing or malformed parse as zero.
+class FieldScanner {
+ public:
+  explicit FieldScanner(std::string_view text)
+      : pos_(text.data()), end_(text.data() + text.size()) {}
+  FieldScanner(const char* begin, const char* end) : pos_(begin), end_(end) {}
+
+  void Skip(int fields) {
+    for (int i = 0; i < fields; ++i) {
+      SkipSpaces();
+      while (pos_ < end_ && !IsSpace(*pos_)) ++pos_;
+    }
+  }
+
+  template <typename T>
+  void Next(T& value) {
+    SkipSpaces();
+    value = 0;
+    auto result = std::from_chars(pos_, end_, value);
+    pos_ = result.ptr;
+    while (pos_ < end_ && !IsSpace(*pos_)) ++pos_;
+  }
+
+  void Next(char& value) {
+    SkipSpaces();
+    if (pos_ < end_) value = *pos_++;
+  }
+
+  std::string_view NextToken() {
+    SkipSpaces();
+    const char* begin = pos_;
+    while (pos_ < end_ && !IsSpace(*pos_)) ++pos_;
+    return std::string_view(begin, pos_ - begin);
+  }
+
+  bool Done() const { return pos_ >= end_; }
+
+ private:
+  static bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\n'; }
+  void SkipSpaces() {
+    while (pos_ < end_ && IsSpace(*pos_)) ++pos_;
+  }
+
+  const char* pos_;
+  const char* end_;
+};
+};  // namespace ProcReader
+
+#endif
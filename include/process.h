@@ -2,25 +2,98 @@
 #define PROCESS_H
 
 #include <string>
+#include <string_view>
+#include <vector>
+
+#include "linux_parser.h"
+#include "string_pool.h"
 /*
 Basic class for Process representation
 It contains relevant attributes as shown below
 */
 class Process {
  public:
-  Process(int pid);
-  int Pid();               // Return this process's ID
-  std::string User();      // Return the user (name) that generated this process
-  std::string Command();   // TODO: See src/process.cpp
+  // One thread of the process, filled in by the thread view
+  struct Thread {
+    int tid;
+    char name[17];  // comm, as in ProcStatSnapshot
+    char state;
+    float cpu;  // share of one core since the previous sample
+  };
+  // Place in the tree view, filled in by System while it is on; cpu and
+  // rss_kb are summed over the process and all of its descendants
+  struct Tree {
+    int depth{0};
+    int descendants{0};
+    bool collapsed{false};  // descendants are not listed
+    float cpu{0.0f};
+    unsigned long rss_kb{0};
+  };
+
+  Process(int pid, const LinuxParser::ProcStatSnapshot& stat,
+          PooledString user);
+  // Rebuild a row from recorded values, for history replay
+  Process(int pid, std::string_view user, std::string_view command, float cpu,
+          unsigned long ram_mb, long start_seconds, long system_uptime);
+  // Take a new stat sample; CPU usage is measured against the previous one
+  void Update(const LinuxParser::ProcStatSnapshot& stat, long system_uptime,
+              float elapsed_seconds);
+  // Take command and user from `image`, read after the process called exec()
+  void Exec(Process&& image);
+  unsigned long long ActiveJiffies() const;  // utime + stime at last sample
+  unsigned long long IntervalJiffies() const;  // used since the sample before
+  int Pid() const;                 // Return this process's ID
+  int ParentPid() const;  // At the last sample
+  // Text is interned (see string_pool.h), so copying a Process copies
+  // three 32-bit handles rather than three strings
+  const PooledString& User() const;  // Return the user (name) that generated this process
+  const PooledString& Command() const;  // The whole command line
+  // cgroup v2 path, resolved with the command (see LinuxParser::Cgroup)
+  const PooledString& Cgroup() const;
   float CpuUtilization() const;  // Return this process's CPU utilization
   std::string Ram();       // Return this process's memory utilization
-  long int UpTime();       // Return the age of this process (in seconds)
+  unsigned long RamMegabytes() const;  // Same as Ram(), as a number
+  unsigned long RssKilobytes() const;  // Resident set size at last sample
+  // PSS, USS and swap from smaps_rollup. Sampled less often than the rest
+  // (see System), so they may be a few refreshes old, and missing where
+  // the file could not be read.
+  bool HasMemoryDetail() const;
+  const LinuxParser::SmapsRollupSnapshot& MemoryDetail() const;
+  void SetMemoryDetail(const LinuxParser::SmapsRollupSnapshot& detail);
+  // Storage I/O in bytes per second since the previous io sample. Unknown
+  // where /proc/[pid]/io cannot be read (another user's process).
+  void UpdateIo(const LinuxParser::ProcIoSnapshot& io, float elapsed_seconds);
+  bool HasIo() const;
+  float ReadRate() const;
+  float WriteRate() const;
+  long int UpTime() const;  // Return the age of this process (in seconds)
+  unsigned long long StartTime() const;  // Jiffies after system boot
+  long ThreadCount() const;  // Threads at the last sample
+  // The busiest threads, busiest first; empty unless the thread view is on
+  const std::vector<Thread>& Threads() const;
+  void SetThreads(const std::vector<Thread>& threads);
+  const Tree& TreePosition() const;
+  void SetTreePosition(const Tree& tree);
   bool operator<(Process const& a) const;  // TODO: See src/process.cpp
 
  private:
   int pid_{0};
-  std::string user_{""};
-  std::string command_{""};
+  PooledString user_{};
+  PooledString command_{};
+  PooledString cgroup_{};
+  long system_uptime_{0};
+  float cpu_{0.0f};
+  unsigned long long active_jiffies_{0};
+  unsigned long long interval_jiffies_{0};
+  LinuxParser::ProcStatSnapshot stat_{};
+  std::vector<Thread> threads_{};
+  Tree tree_{};
+  bool has_memory_detail_{false};
+  LinuxParser::SmapsRollupSnapshot memory_detail_{};
+  bool has_io_{false};
+  LinuxParser::ProcIoSnapshot io_{};
+  float read_rate_{0.0f};
+  float write_rate_{0.0f};
 };
 
-#endif
\ No newline at end of file
+#endif
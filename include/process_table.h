@@ -0,0 +1,67 @@
+#ifndef PROCESS_TABLE_H
+#define PROCESS_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "process.h"
+
+/*
+The fields System filters and ranks by, stored as one packed array per
+field with one row per live process. This is an index, not the storage:
+System keeps each Process in its table and copies these fields out of it
+on every refresh, so a row number is only meaningful until the next
+Clear().
+Filtering runs one pass over the columns that the compiler can vectorize,
+then compacts the passing row numbers. Ranking sorts 16-byte (value, row)
+keys instead of touching Process, so neither step pulls strings, stat
+snapshots or thread lists into the cache.
+*/
+class ProcessTable {
+ public:
+  enum class Column { kCpu, kRss, kIo };
+  struct Filter {
+    float min_cpu{0.0f};  // share of one core, as Process::CpuUtilization
+    std::uint32_t user{0};  // PooledString ID of the user name; 0 for any
+    std::uint32_t command{0};  // ID of the whole command line; 0 for any
+  };
+
+  void Clear();
+  void Append(const Process& process);
+  std::size_t Size() const;
+  int Pid(std::size_t row) const;
+  unsigned long long StartTime(std::size_t row) const;
+  std::uint32_t Command(std::size_t row) const;  // PooledString ID
+
+  // Fill `order` with every row number, the rows passing `filter` first,
+  // and return how many passed
+  std::size_t Select(const Filter& filter,
+                     std::vector<std::uint32_t>& order);
+  // Put the n rows of order[0, count) ranking highest by `column` first,
+  // highest first (ties oldest first, then by PID); the rest of
+  // order[0, count) follows in no particular order
+  void Rank(Column column, std::vector<std::uint32_t>& order,
+            std::size_t count, std::size_t n);
+
+ private:
+  struct Key {
+    double value;
+    std::uint32_t row;
+  };
+  template <typename T>
+  void Gather(const std::vector<T>& values,
+              const std::vector<std::uint32_t>& order, std::size_t count);
+
+  std::vector<int> pid_;
+  std::vector<float> cpu_;
+  std::vector<unsigned long> rss_kb_;
+  std::vector<float> io_;  // read + write bytes/s
+  std::vector<std::uint32_t> user_;
+  std::vector<unsigned long long> start_;  // jiffies after boot
+  std::vector<std::uint32_t> command_;
+  std::vector<std::uint8_t> pass_;  // scratch for Select()
+  std::vector<Key> keys_;           // scratch for Rank()
+};
+
+#endif
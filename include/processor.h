@@ -1,9 +1,38 @@
 #ifndef PROCESSOR_H
 #define PROCESSOR_H
 
+#include <cstddef>
+#include <vector>
+
+#include "system_snapshot.h"
+
+// Share of the last sampling interval spent in each state (0..1)
+struct CpuBreakdown {
+  float user{0.0f};    // user + nice
+  float system{0.0f};
+  float irq{0.0f};     // irq + softirq
+  float steal{0.0f};
+  float iowait{0.0f};
+  float idle{0.0f};
+  float Busy() const { return user + system + irq + steal; }
+};
+
 class Processor {
  public:
+  void Update(const SystemSnapshot& snapshot);  // Take a new sample
   float Utilization();  // See src/processor.cpp
+  const CpuBreakdown& Breakdown() const;  // Aggregate, split by state
+  std::size_t Cores() const;
+  float CoreUtilization(std::size_t core) const;
+
+ private:
+  static CpuBreakdown Interval(const CpuTimes& previous,
+                               const CpuTimes& current);
+
+  CpuTimes previous_{};
+  std::vector<CpuTimes> previous_cores_;
+  CpuBreakdown aggregate_;
+  std::vector<float> cores_;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,53 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <cstddef>
+
+/*
+How often each per-process source is read. Every source declares what a
+read costs and how many refreshes its value may age, separately for the
+processes being listed and for the others; System asks Due() before each
+read.
+Listed processes are read as soon as their value is as old as allowed.
+The others are read in slices, and the cost sets the slice: each source
+may spend at most kBackgroundBudget per refresh on them. A small host
+reads them as often as their age allows; on a large one the budget wins
+and their values age longer than that.
+Sources that are not scheduled:
+  - stat is read for every process on every refresh: CPU ranking needs all
+    of them, and it is the cheapest file.
+  - command, user and cgroup are read once per process, and again only
+    after exec(); the OS name and kernel version once per run.
+*/
+namespace Scheduler {
+enum Source { kIo, kSmapsRollup, kSources };
+
+// Cost units per refresh each source may spend on processes not listed
+constexpr unsigned long kBackgroundBudget = 600;
+
+struct Policy {
+  const char* name;
+  // Cost of one read: the syscalls it makes (openat, read(s), close),
+  // weighted up where the kernel does much more work than a copy
+  unsigned long cost;
+  unsigned long listed;  // most refreshes a listed process's value may age
+  // The same for the others, while the budget allows (see Period())
+  unsigned long hidden;
+};
+const Policy& Of(Source source);
+
+// Refreshes between reads of a process that is not listed, when
+// `population` such processes share the budget: `hidden`, or longer where
+// reading every process that often would cost more than
+// kBackgroundBudget per refresh
+unsigned long Period(Source source, std::size_t population);
+
+// Is `source` due at refresh `tick` for a process last read at refresh
+// `sampled` (0: never)? The processes not listed are read in slices by
+// PID, `population` of them in all, so that each refresh reads about
+// 1/Period() of them.
+bool Due(Source source, unsigned long tick, unsigned long sampled,
+         bool listed, int pid, std::size_t population);
+};  // namespace Scheduler
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <vector>
+
+#include "disk_stats.h"
+#include "instrument.h"
+#include "process.h"
+#include "processor.h"
+#include "system.h"
+
+// Time spent in each stage of one tick, in milliseconds
+struct StageLatency {
+  double collect{0.0};  // reading /proc
+  double sort{0.0};     // ranking the process table
+  double render{0.0};   // drawing the previous snapshot
+};
+
+// Everything one frame needs, copied out of System by the collector thread
+// so the display never reads /proc itself
+struct Snapshot {
+  unsigned long sequence{0};
+  long long timestamp_ms{0};  // wall clock, milliseconds since the epoch
+  long long interval_ms{0};   // the collector's interval at the time
+  std::string operating_system;
+  std::string kernel;
+  float cpu{0.0f};
+  CpuBreakdown breakdown;
+  std::vector<float> cores;
+  float memory{0.0f};  // used, without reclaimable cache
+  float cache{0.0f};   // buffers and reclaimable cache
+  float swap{0.0f};
+  std::vector<DiskRate> disks;
+  LoadAverage load;
+  bool has_pressure{false};
+  Pressure cpu_pressure;
+  Pressure memory_pressure;
+  Pressure io_pressure;
+  int total_processes{0};
+  int running_processes{0};
+  long uptime{0};
+  std::vector<Process> processes;  // highest ranking first
+  bool tree_view{false};  // processes are rows of the process tree
+  bool group_view{false};
+  std::vector<CgroupUsage> cgroups;  // highest ranking first
+  System::SortOrder sort{System::SortOrder::kCpu};
+  std::vector<System::ExitedProcess> exited;
+  StageLatency latency;
+  // What the monitor itself spent since the previous snapshot; render and
+  // export time is that of the previous snapshot. Only filled in while
+  // instrumentation is enabled.
+  bool instrumented{false};
+  Instrument::Counters cost;
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+Deduplicated strings for the text every process carries: command line,
+user name and cgroup path. Thousands of processes share a few dozen
+distinct values, so each value is stored once and a process holds a 32-bit
+PooledString handle to it.
+Handles are reference counted. Copying one is an atomic increment instead
+of an allocation and a copy, and a string is freed with its last handle.
+Text is stored NUL terminated in blocks carved from 256 KiB chunks, in
+power-of-two size classes; a freed block is reused for the next string of
+its class. Stored bytes never move, so a string can be read from any
+thread holding a handle to it without locking. Interning and freeing take
+a mutex.
+*/
+class StringPool {
+ public:
+  static constexpr std::size_t kMaxLength = 65535;  // longer text is cut
+  static StringPool& Shared();  // The pool PooledString uses
+
+  // Return the ID of `text` with one reference taken; 0 for ""
+  std::uint32_t Intern(std::string_view text);
+  void Acquire(std::uint32_t id);  // Only for IDs already referenced
+  void Release(std::uint32_t id);
+  std::string_view View(std::uint32_t id) const;
+
+  struct Usage {
+    std::size_t strings{0};  // distinct strings alive
+    std::size_t bytes{0};    // chunks, entry table and index
+  };
+  Usage Stats() const;
+
+ private:
+  struct Entry {
+    std::atomic<std::uint32_t> references{0};
+    std::uint32_t length{0};
+    char* data{nullptr};  // nullptr while the entry is free
+  };
+  static constexpr unsigned kSegmentBits = 14;
+  static constexpr std::size_t kSegmentSize = std::size_t(1) << kSegmentBits;
+  static constexpr std::size_t kSegments = 1024;  // 16M strings
+  static constexpr std::size_t kChunkSize = 256 * 1024;
+  static constexpr unsigned kMinClass = 4;   // 16 bytes
+  static constexpr unsigned kMaxClass = 16;  // 64 KiB, kMaxLength + NUL
+
+  Entry& At(std::uint32_t id) const;
+  std::uint32_t NewEntry();
+  char* Allocate(unsigned size_class);
+  void Free(std::uint32_t id);
+
+  mutable std::mutex mutex_;
+  // Entries are added a segment at a time so they never move; ID 0 is
+  // the empty string and has no entry
+  std::unique_ptr<Entry[]> segments_[kSegments];
+  std::uint32_t entries_{1};
+  std::vector<std::uint32_t> free_entries_;
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  std::size_t chunk_used_{kChunkSize};
+  std::vector<char*> free_blocks_[kMaxClass + 1];
+  std::unordered_map<std::string_view, std::uint32_t> index_;
+};
+
+// A handle to a string in StringPool::Shared(), 4 bytes in size
+class PooledString {
+ public:
+  PooledString() = default;
+  explicit PooledString(std::string_view text);
+  PooledString(const PooledString& other);
+  PooledString(PooledString&& other) noexcept;
+  PooledString& operator=(PooledString other) noexcept;
+  ~PooledString();
+
+  std::string_view View() const;
+  operator std::string_view() const { return View(); }
+  const char* c_str() const;  // NUL terminated
+  std::size_t size() const;
+  bool empty() const;
+  // Equal for equal strings, as long as both are alive
+  std::uint32_t Id() const;
+
+ private:
+  std::uint32_t id_{0};
+};
+
+#endif
@@ -1,28 +1,237 @@
 #ifndef SYSTEM_H
 #define SYSTEM_H
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "cgroup_stats.h"
+#include "disk_stats.h"
 #include "linux_parser.h"
 #include "process.h"
+#include "process_table.h"
+#include "proc_connector.h"
 #include "processor.h"
+#include "system_snapshot.h"
+#include "thread_pool.h"
+#include "user_cache.h"
 
 class System {
  public:
+  // A process that has exited, with its CPU totals at exit
+  struct ExitedProcess {
+    int pid;
+    PooledString command;
+    unsigned long long cpu_jiffies;  // utime + stime
+  };
+
+  // Time spent in the last call to Processes(), in milliseconds
+  struct StageTimes {
+    double collect{0.0};  // reading /proc and updating the table
+    double sort{0.0};     // selecting and copying the top N
+  };
+
+  // Per-process collection is spread over `threads` threads (at least one).
+  // With proc_events, new and exited processes are tracked through the
+  // kernel proc connector instead of listing /proc on every refresh.
+  explicit System(unsigned threads = std::thread::hardware_concurrency(),
+                  bool proc_events = false);
+  void Refresh();  // Sample the system wide counters for the next frame
   Processor& Cpu();                   // TODO: See src/system.cpp
-  std::vector<Process>& Processes();  // TODO: See src/system.cpp
+  const DiskStats& Disks() const;  // Per-disk throughput
+  // What Processes() ranks by: CPU usage over the last interval, resident
+  // memory, or storage I/O (read + write) over the last interval
+  enum class SortOrder { kCpu, kMemory, kIo };
+  void Sort(SortOrder order);
+  SortOrder Sort() const;
+  // Return the n processes ranking highest, highest first
+  std::vector<Process>& Processes(int n = 10);
+  // List only the processes using at least `min_cpu` (a share of one
+  // core) and, unless they are empty, owned by `user` and running exactly
+  // `command` (the whole command line). Applies to the flat list; the tree
+  // and cgroup views show everything. Not to be changed while another
+  // thread calls Processes().
+  void Filter(float min_cpu, const std::string& user = "",
+              const std::string& command = "");
+  // smaps_rollup (PSS, USS, swap) and io are read on the cadence set in
+  // scheduler.h: often for the processes returned, in slices by PID for
+  // the others. Sorting by I/O reads io for every process every refresh.
+  // With the thread view on, Processes() also samples the threads of the
+  // n processes it returns (and of no others), so the cost grows with n
+  // and not with the number of threads on the host. At most kMaxThreads
+  // threads are read per process and the kThreadsShown busiest are kept.
+  // Off, smaps_rollup is not read at all and no process has memory
+  // detail; for callers that show no PSS, USS or swap
+  void MemoryDetail(bool enabled);
+  bool MemoryDetail() const;
+  static constexpr std::size_t kMaxThreads = 4096;
+  static constexpr std::size_t kThreadsShown = 4;
+  void ThreadView(bool enabled);
+  bool ThreadView() const;
+  // With the tree view on, Processes() returns the first n rows of the
+  // process tree instead: children below their parent, siblings ordered by
+  // the sort order applied to whole subtrees, and CPU and RSS summed over
+  // each subtree (see Process::Tree). Levels below the first TreeDepth()
+  // are collapsed into their parent.
+  static constexpr int kTreeDepth = 3;
+  void TreeView(bool enabled);
+  bool TreeView() const;
+  void TreeDepth(int depth);  // At least 1
+  int TreeDepth() const;
+  // With the group view on, Processes() also rolls every process up by
+  // cgroup v2 and ranks the cgroups by the same sort order (see
+  // CgroupStats)
+  void GroupView(bool enabled);
+  bool GroupView() const;
+  // The n cgroups ranking highest in the last call to Processes(), highest
+  // first; empty unless the group view is on
+  const std::vector<CgroupUsage>& Cgroups() const;
+  // Processes that exited during the last call to Processes()
+  const std::vector<ExitedProcess>& ExitedProcesses() const;
+  bool ProcEvents() const;  // Is the proc connector in use?
+  const StageTimes& LastStageTimes() const;
   float MemoryUtilization();          // TODO: See src/system.cpp
+  const LinuxParser::MemInfo& Memory() const;
+  const LoadAverage& Load() const;
+  bool HasPressure() const;  // Is /proc/pressure available?
+  const Pressure& CpuPressure() const;
+  const Pressure& MemoryPressure() const;
+  const Pressure& IoPressure() const;
   long UpTime();                      // TODO: See src/system.cpp
   int TotalProcesses();               // TODO: See src/system.cpp
   int RunningProcesses();             // TODO: See src/system.cpp
-  std::string Kernel();               // TODO: See src/system.cpp
-  std::string OperatingSystem();      // TODO: See src/system.cpp
+  const std::string& Kernel() const;           // Read once, at construction
+  const std::string& OperatingSystem() const;  // Read once, at construction
 
-  // TODO: Define any necessary private members
  private:
+  // A PID can be reused once its process exits, so the start time is part
+  // of the identity of a process
+  struct ProcessKey {
+    int pid;
+    unsigned long long starttime;
+    bool operator==(const ProcessKey& other) const {
+      return pid == other.pid && starttime == other.starttime;
+    }
+  };
+  struct ProcessKeyHash {
+    std::size_t operator()(const ProcessKey& key) const {
+      return std::hash<unsigned long long>()(key.starttime * 4194304ULL +
+                                             key.pid);
+    }
+  };
+  struct TrackedProcess {
+    Process process;
+    unsigned long generation;
+    unsigned long memory_sampled{0};  // refresh of the last smaps_rollup read
+    bool memory_denied{false};        // no access; not tried again
+    bool io_denied{false};            // same, for /proc/[pid]/io
+    unsigned long io_sampled{0};      // refresh of the last io read
+    std::chrono::steady_clock::time_point io_time{};  // and its time
+    int parent{-1};  // PID it is filed under in children_
+  };
+  // Result of collecting one PID. Each slot is written by exactly one
+  // worker, so no lock is needed until the results are merged.
+  struct Sample {
+    bool valid;
+    LinuxParser::ProcStatSnapshot stat;
+    bool io_valid;
+    bool io_denied;
+    LinuxParser::ProcIoSnapshot io;
+    std::optional<Process> created;  // set for processes not in the table
+  };
+  // One thread read by the thread view; `stat.pid` is the TID
+  struct TrackedThread {
+    unsigned long long jiffies;
+    unsigned long generation;
+  };
+  ThreadPool pool_;
+  const std::string kernel_;
+  const std::string operating_system_;
+  UserCache users_;
+  SystemSampler sampler_;
+  SystemSnapshot snapshot_ = {};
   Processor cpu_ = {};
+  DiskStats disks_ = {};
+  // Event backend. A full /proc scan still runs every kReconcileInterval
+  // refreshes, and whenever events were lost.
+  static constexpr unsigned long kReconcileInterval = 30;
+  std::vector<int> CollectPids();
+  void Scan(std::chrono::steady_clock::time_point now);
+  void Rank(int n);
+  void SampleMemory();
+  void SampleIo();
+  void UpdateIo(TrackedProcess& tracked,
+                const LinuxParser::ProcIoSnapshot& io);
+  void ExpandThreads();
+  void RankCgroups(int n);
+  void Reparent(TrackedProcess& tracked, int parent);
+  void BuildTree(int n);
+  ProcConnector connector_;
+  std::vector<ProcConnector::Event> events_ = {};
+  std::unordered_set<int> live_pids_ = {};
+  std::unordered_set<int> exec_pids_ = {};
+  unsigned long reconciled_at_ = 0;
+  std::vector<ExitedProcess> exited_ = {};
+  StageTimes stage_times_ = {};
   std::vector<Process> processes_ = {};
+  // Processes seen so far, updated in place on every refresh
+  std::unordered_map<ProcessKey, TrackedProcess, ProcessKeyHash> table_ = {};
+  std::vector<Sample> samples_ = {};
+  // The live processes as packed columns for filtering and ranking, and
+  // their table entries by row. order_ lists the rows passing the filter
+  // first (selected_ of them), the first ranked_ of those in rank order.
+  ProcessTable rows_ = {};
+  std::vector<TrackedProcess*> tracked_ = {};
+  std::vector<std::uint32_t> order_ = {};
+  std::size_t selected_ = 0;
+  ProcessTable::Filter filter_ = {};
+  // Keep the filter's IDs bound to their strings
+  PooledString filter_user_ = {};
+  PooledString filter_command_ = {};
+  // Child index, kept up to date as processes arrive, exit or are
+  // reparented rather than rebuilt on every refresh: live processes by PID,
+  // and the children of each parent PID
+  std::unordered_map<int, TrackedProcess*> by_pid_ = {};
+  std::unordered_map<int, std::vector<TrackedProcess*>> children_ = {};
+  // The whole tree in pre-order, so every subtree is a contiguous range
+  // that follows its root, and the rows shown
+  struct TreeNode {
+    TrackedProcess* tracked;
+    int parent;  // index in tree_, -1 for a root
+    Process::Tree tree;
+    double io;  // read + write bytes/s of the subtree, for sorting
+  };
+  std::vector<TreeNode> tree_ = {};
+  std::vector<std::pair<TrackedProcess*, int>> tree_stack_ = {};
+  std::vector<int> tree_rows_ = {};
+  std::vector<int> siblings_ = {};
+  std::atomic<bool> tree_view_{false};
+  std::atomic<int> tree_depth_{kTreeDepth};
+  std::size_t ranked_ = 0;
+  std::atomic<SortOrder> sort_{SortOrder::kCpu};
+  std::vector<TrackedProcess*> memory_due_ = {};
+  std::vector<TrackedProcess*> io_due_ = {};
+  unsigned long generation_ = 0;
+  std::chrono::steady_clock::time_point last_refresh_ = {};
+  float elapsed_ = 0.0f;  // seconds between the last two refreshes
+  std::atomic<bool> memory_detail_{true};
+  std::atomic<bool> thread_view_{false};
+  std::atomic<bool> group_view_{false};
+  CgroupStats cgroup_stats_ = {};
+  std::vector<CgroupUsage> cgroups_ = {};
+  // Threads of the processes expanded so far, keyed by TID and start time
+  std::unordered_map<ProcessKey, TrackedThread, ProcessKeyHash> threads_ =
+      {};
+  // Stat of every thread read this refresh, one slot per expanded process
+  std::vector<std::vector<LinuxParser::ProcStatSnapshot>> task_stats_ = {};
+  std::vector<Process::Thread> thread_rows_ = {};
 };
 
-#endif
\ No newline at end of file
+#endif
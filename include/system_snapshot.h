@@ -0,0 +1,104 @@
+#ifndef SYSTEM_SNAPSHOT_H
+#define SYSTEM_SNAPSHOT_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "linux_parser.h"
+
+// Jiffies of one "cpu" line of /proc/stat, indexed by LinuxParser::CPUStates
+using CpuTimes = std::array<std::uint64_t, 10>;
+
+// Cumulative counters of one whole disk from /proc/diskstats
+struct DiskCounters {
+  char name[32]{};
+  std::uint64_t sectors_read{0};     // 512 byte units
+  std::uint64_t sectors_written{0};
+  std::uint64_t io_ms{0};            // time with requests in flight
+};
+
+// /proc/loadavg
+struct LoadAverage {
+  float one{0.0f};
+  float five{0.0f};
+  float fifteen{0.0f};
+  int runnable{0};  // scheduling entities running or ready to run
+  int total{0};     // scheduling entities that exist
+};
+
+// One resource of /proc/pressure: the share of wall time in which some
+// (or all, for "full") runnable tasks were stalled on it, as averaged by
+// the kernel over 10, 60 and 300 seconds, and the total stall time
+struct Pressure {
+  struct Line {
+    float avg10{0.0f};  // percent
+    float avg60{0.0f};
+    float avg300{0.0f};
+    std::uint64_t total_us{0};
+  };
+  Line some;
+  Line full;  // always zero for cpu at the system level
+};
+
+// System wide counters from /proc/stat, /proc/meminfo, /proc/uptime,
+// /proc/diskstats, /proc/loadavg and /proc/pressure
+struct SystemSnapshot {
+  CpuTimes cpu{};               // aggregate "cpu" line
+  std::vector<CpuTimes> cores;  // "cpuN" lines, indexed by N
+  int total_processes{0};
+  int running_processes{0};
+  LinuxParser::MemInfo meminfo;
+  double uptime{0.0};  // seconds
+  std::vector<DiskCounters> disks;
+  LoadAverage load;
+  // Kernels built without CONFIG_PSI (or booted with psi=0) have no
+  // /proc/pressure
+  bool has_pressure{false};
+  Pressure cpu_pressure;
+  Pressure memory_pressure;
+  Pressure io_pressure;
+};
+
+/*
+Keeps the global /proc files open for the lifetime of the program and
+refreshes a SystemSnapshot with one pread() per file and one parsing pass
+over each file's contents.
+*/
+class SystemSampler {
+ public:
+  SystemSampler();
+  ~SystemSampler();
+  SystemSampler(const SystemSampler&) = delete;
+  SystemSampler& operator=(const SystemSampler&) = delete;
+
+  bool Refresh(SystemSnapshot& snapshot);
+
+ private:
+  struct File {
+    int fd{-1};
+    std::vector<char> buffer;
+  };
+  static void Open(File& file, const std::string& path);
+  static bool Read(File& file, std::string_view& contents);
+  void ParseDiskstats(std::string_view contents, SystemSnapshot& snapshot);
+  bool WholeDisk(std::string_view name);
+
+  File stat_;
+  File meminfo_;
+  File uptime_;
+  File diskstats_;
+  File loadavg_;
+  File cpu_pressure_;
+  File memory_pressure_;
+  File io_pressure_;
+  // Device name and whether it is a whole disk (partitions are left out),
+  // looked up in /sys/block once per name. A host has few block devices,
+  // so a linear search beats hashing, and it takes the name as a view.
+  std::vector<std::pair<std::string, bool>> whole_disks_;
+};
+
+#endif
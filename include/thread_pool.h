@@ -0,0 +1,59 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+Fixed pool of worker threads with one task queue per worker.
+A worker takes work from the front of its own queue and, once that is
+empty, steals from the back of the other queues, so a few slow tasks do not
+hold up the rest of the batch.
+*/
+class ThreadPool {
+ public:
+  // The calling thread takes part in every batch, so `threads` counts it
+  explicit ThreadPool(unsigned threads);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Call task(begin, end) over [0, count) in chunks of at most `chunk`
+  // elements and return once every chunk is done. Batches do not nest.
+  void ParallelFor(std::size_t count, std::size_t chunk,
+                   const std::function<void(std::size_t, std::size_t)>& task);
+  unsigned Size() const;  // Number of threads, including the caller
+
+ private:
+  struct Range {
+    std::size_t begin;
+    std::size_t end;
+  };
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Range> ranges;
+  };
+
+  void Worker(unsigned index);
+  void RunTasks(unsigned index);
+  bool Pop(unsigned index, Range& range);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  const std::function<void(std::size_t, std::size_t)>* task_{nullptr};
+  std::atomic<std::size_t> pending_{0};
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  unsigned long batch_{0};
+  bool stop_{false};
+};
+
+#endif
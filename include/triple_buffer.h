@@ -0,0 +1,46 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+/*
+Lock-free hand-over of values from one writer thread to one reader thread.
+The writer fills Back() and calls Publish(); the reader calls Update() and
+then reads Front(). Three slots rotate through an atomic index exchange, so
+neither side ever waits and the reader always gets the newest value. Slots
+are reused, so values that keep their capacity (vectors, strings) stop
+allocating once they have grown.
+*/
+template <typename T>
+class TripleBuffer {
+ public:
+  T& Back() { return slots_[back_]; }
+  // Hand the back slot over to the reader
+  void Publish() {
+    unsigned previous = middle_.exchange(back_ | kFresh,
+                                         std::memory_order_acq_rel);
+    back_ = previous & kIndex;
+  }
+
+  // Take the newest published slot, if there is one since the last call
+  bool Update() {
+    if ((middle_.load(std::memory_order_acquire) & kFresh) == 0) {
+      return false;
+    }
+    unsigned previous = middle_.exchange(front_, std::memory_order_acq_rel);
+    front_ = previous & kIndex;
+    return true;
+  }
+  T& Front() { return slots_[front_]; }
+
+ private:
+  static constexpr unsigned kIndex = 3;
+  static constexpr unsigned kFresh = 4;
+
+  T slots_[3];
+  unsigned front_{0};
+  std::atomic<unsigned> middle_{1};
+  unsigned back_{2};
+};
+
+#endif
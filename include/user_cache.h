@@ -0,0 +1,47 @@
+#ifndef USER_CACHE_H
+#define USER_CACHE_H
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <ctime>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "linux_parser.h"
+#include "string_pool.h"
+
+/*
+UID to user name lookup.
+The password file is loaded once into a hash map and only reloaded when its
+inode or modification time changes. UIDs it does not list (LDAP, SSSD, ...)
+are resolved through getpwuid_r; UIDs nobody knows are remembered for a
+while so they are not looked up again on every refresh.
+Names are interned, so handing one to a process copies a handle.
+Name() may be called from several threads at once.
+*/
+class UserCache {
+ public:
+  explicit UserCache(
+      std::string path = LinuxParser::kPasswordPath,
+      std::chrono::seconds negative_ttl = std::chrono::seconds(60));
+
+  PooledString Name(uid_t uid);  // Return the user name, or the UID as text
+  void Refresh();               // Reload the password file if it changed
+
+ private:
+  void Load();
+  static bool LookupSystem(uid_t uid, std::string& name);
+
+  std::string path_;
+  std::chrono::seconds negative_ttl_;
+  std::shared_mutex mutex_;
+  std::unordered_map<uid_t, PooledString> names_;
+  std::unordered_map<uid_t, std::chrono::steady_clock::time_point> misses_;
+  dev_t device_{0};
+  ino_t inode_{0};
+  timespec modified_{};
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include "cgroup_stats.h"
+
+#include "linux_parser.h"
+
+CgroupStats::CgroupStats() : root_(LinuxParser::CgroupRoot()) {}
+
+void CgroupStats::Add(const Process& process) {
+  if (process.Cgroup().empty()) {
+    return;  // no cgroup v2 membership
+  }
+  Tracked& tracked = groups_[process.Cgroup().Id()];
+  if (tracked.path.empty()) {
+    tracked.path = process.Cgroup();
+  }
+  if (tracked.generation != generation_) {
+    tracked.generation = generation_;
+    tracked.usage.processes = 0;
+    tracked.rss_kb = 0;
+  }
+  ++tracked.usage.processes;
+  tracked.rss_kb += process.RssKilobytes();
+}
+
+void CgroupStats::Update(float elapsed_seconds) {
+  usage_.clear();
+  for (auto it = groups_.begin(); it != groups_.end();) {
+    Tracked& tracked = it->second;
+    if (tracked.generation != generation_) {
+      it = groups_.erase(it);
+      continue;
+    }
+    // Where the files cannot be read every counter stays unknown
+    LinuxParser::CgroupCounters counters;
+    directory_.assign(root_).append(tracked.path.View());
+    LinuxParser::ReadCgroup(directory_, counters);
+    CgroupUsage& usage = tracked.usage;
+    usage.path.assign(tracked.path.View());
+    usage.memory_kb = counters.memory_bytes >= 0
+                          ? counters.memory_bytes / 1024
+                          : tracked.rss_kb;
+    usage.has_io = counters.read_bytes >= 0;
+    usage.cpu = usage.read_bps = usage.write_bps = 0.0f;
+    const LinuxParser::CgroupCounters& previous = tracked.previous;
+    if (tracked.sampled && elapsed_seconds > 0.0f) {
+      auto rate = [&](long long now, long long before) {
+        return now >= 0 && before >= 0 && now > before
+                   ? float(now - before) / elapsed_seconds
+                   : 0.0f;
+      };
+      usage.cpu = rate(counters.usage_usec, previous.usage_usec) / 1e6f;
+      usage.read_bps = rate(counters.read_bytes, previous.read_bytes);
+      usage.write_bps = rate(counters.write_bytes, previous.write_bytes);
+    }
+    tracked.previous = counters;
+    tracked.sampled = true;
+    usage_.push_back(usage);
+    ++it;
+  }
+  ++generation_;
+}
+
+std::vector<CgroupUsage>& CgroupStats::Usage() { return usage_; }
@@ -0,0 +1,154 @@
+#include "collector.h"
+
+#include <algorithm>
+#include <chrono>
+
+using Clock = std::chrono::steady_clock;
+
+Collector::Collector(System& system, int n, std::chrono::milliseconds interval)
+    : system_(system),
+      n_(n),
+      interval_(std::clamp(interval, kMinInterval, kMaxInterval)) {}
+
+Collector::~Collector() { Stop(); }
+
+void Collector::Record(History* history) { history_ = history; }
+
+void Collector::WatchPressure(PressureTrigger* trigger) {
+  trigger_ = trigger != nullptr && trigger->Armed() ? trigger : nullptr;
+}
+
+void Collector::Interval(std::chrono::milliseconds interval) {
+  interval_ = std::clamp(interval, kMinInterval, kMaxInterval);
+}
+
+std::chrono::milliseconds Collector::Interval() const { return interval_; }
+
+void Collector::Start() { thread_ = std::thread(&Collector::Run, this); }
+
+void Collector::Stop() {
+  stop_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void Collector::CollectNow(Snapshot& snapshot) { Collect(snapshot); }
+
+bool Collector::Update() { return buffer_.Update(); }
+
+Snapshot& Collector::Latest() { return buffer_.Front(); }
+
+void Collector::ReportRender(double milliseconds) { render_ = milliseconds; }
+
+// Ticks are paced against deadlines, so the time spent collecting does not
+// stretch the interval. Stop() is noticed within 50 ms. A firing pressure
+// trigger ends the wait early and switches to the fast interval.
+void Collector::Run() {
+  deadline_ = Clock::now();
+  while (!stop_) {
+    Collect(buffer_.Back());
+    buffer_.Publish();
+    WaitForTick();
+  }
+}
+
+// The next deadline is worked out again on every slice, so an interval
+// changed (or pressure that ended) during the wait moves it
+void Collector::WaitForTick() {
+  auto last = deadline_;
+  auto now = Clock::now();
+  auto due = [&] {
+    return last + (now < pressure_until_ ? kPressureInterval : Interval());
+  };
+  if (due() < now) {
+    deadline_ = now;  // fell behind; do not try to catch up
+    return;
+  }
+  while (!stop_ && (now = Clock::now()) < due()) {
+    auto slice = std::min(due(), now + std::chrono::milliseconds(50));
+    if (trigger_ == nullptr) {
+      std::this_thread::sleep_until(slice);
+      continue;
+    }
+    if (trigger_->Wait(
+            std::chrono::ceil<std::chrono::milliseconds>(slice - now))) {
+      // The kernel reports at most once per window while the stall lasts,
+      // so two quiet windows mean the pressure is over
+      now = Clock::now();
+      bool calm = now >= pressure_until_;
+      pressure_until_ = now + 2 * trigger_->Window();
+      if (calm) {
+        deadline_ = now;
+        return;
+      }
+    }
+  }
+  deadline_ = due();
+}
+
+void Collector::Collect(Snapshot& snapshot) {
+  auto start = Clock::now();
+  {
+    INSTRUMENT_STAGE(kCollect);
+    system_.Refresh();
+    snapshot.sequence = ++sequence_;
+    snapshot.timestamp_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    snapshot.interval_ms = Interval().count();
+    snapshot.operating_system = system_.OperatingSystem();
+    snapshot.kernel = system_.Kernel();
+    Processor& cpu = system_.Cpu();
+    snapshot.cpu = cpu.Utilization();
+    snapshot.breakdown = cpu.Breakdown();
+    snapshot.cores.resize(cpu.Cores());
+    for (std::size_t i = 0; i < cpu.Cores(); ++i) {
+      snapshot.cores[i] = cpu.CoreUtilization(i);
+    }
+    snapshot.memory = system_.MemoryUtilization();
+    snapshot.cache = system_.Memory().Cache();
+    snapshot.swap = system_.Memory().Swap();
+    snapshot.disks = system_.Disks().Rates();
+    snapshot.load = system_.Load();
+    snapshot.has_pressure = system_.HasPressure();
+    snapshot.cpu_pressure = system_.CpuPressure();
+    snapshot.memory_pressure = system_.MemoryPressure();
+    snapshot.io_pressure = system_.IoPressure();
+    snapshot.total_processes = system_.TotalProcesses();
+    snapshot.running_processes = system_.RunningProcesses();
+    snapshot.uptime = system_.UpTime();
+  }
+  auto system_done = Clock::now();
+
+  snapshot.sort = system_.Sort();
+  snapshot.tree_view = system_.TreeView();
+  snapshot.group_view = system_.GroupView();
+  snapshot.processes = system_.Processes(n_);
+  snapshot.cgroups = system_.Cgroups();
+  snapshot.exited = system_.ExitedProcesses();
+
+  const System::StageTimes& times = system_.LastStageTimes();
+  snapshot.latency.collect =
+      std::chrono::duration<double, std::milli>(system_done - start).count() +
+      times.collect;
+  snapshot.latency.sort = times.sort;
+  snapshot.latency.render = render_;
+
+  // The first tick after instrumentation is switched on has no baseline
+  snapshot.instrumented = false;
+  if (Instrument::Enabled()) {
+    Instrument::Counters totals = Instrument::Totals();
+    snapshot.instrumented = counted_;
+    snapshot.cost = totals - counters_;
+    counters_ = totals;
+    counted_ = true;
+  } else {
+    counted_ = false;
+  }
+
+  if (history_ != nullptr) {
+    history_->Append(snapshot);
+  }
+}
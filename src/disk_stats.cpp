@@ -0,0 +1,48 @@
+#include "disk_stats.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr double kSectorBytes = 512.0;  // diskstats unit, whatever the disk
+}  // namespace
+
+// Compare each disk with its previous sample. Disks are matched by name,
+// since one may be added or removed between two samples.
+void DiskStats::Update(const SystemSnapshot& snapshot) {
+  double elapsed = snapshot.uptime - previous_uptime_;
+  rates_.resize(snapshot.disks.size());
+  for (std::size_t i = 0; i < snapshot.disks.size(); ++i) {
+    const DiskCounters& current = snapshot.disks[i];
+    DiskRate& rate = rates_[i];
+    rate = DiskRate();
+    std::memcpy(rate.name, current.name, sizeof(rate.name));
+    const DiskCounters* previous = nullptr;
+    if (i < previous_.size() &&
+        std::strcmp(previous_[i].name, current.name) == 0) {
+      previous = &previous_[i];
+    } else {
+      auto it = std::find_if(previous_.begin(), previous_.end(),
+                             [&](const DiskCounters& counters) {
+                               return std::strcmp(counters.name,
+                                                  current.name) == 0;
+                             });
+      if (it != previous_.end()) previous = &*it;
+    }
+    if (previous == nullptr || elapsed <= 0.0) continue;
+    auto delta = [](std::uint64_t now, std::uint64_t before) {
+      return now > before ? double(now - before) : 0.0;
+    };
+    rate.read_bps = delta(current.sectors_read, previous->sectors_read) *
+                    kSectorBytes / elapsed;
+    rate.write_bps =
+        delta(current.sectors_written, previous->sectors_written) *
+        kSectorBytes / elapsed;
+    rate.utilization = std::min(
+        1.0, delta(current.io_ms, previous->io_ms) / (elapsed * 1000.0));
+  }
+  previous_ = snapshot.disks;
+  previous_uptime_ = snapshot.uptime;
+}
+
+const std::vector<DiskRate>& DiskStats::Rates() const { return rates_; }
@@ -0,0 +1,465 @@
+#include "exporter.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "collector.h"
+#include "instrument.h"
+
+Exporter::Exporter(Encoding encoding)
+    : encoding_(encoding), buffer_(64 * 1024) {}
+
+Exporter::~Exporter() {
+  if (owns_fd_) {
+    close(fd_);
+  }
+}
+
+bool Exporter::Open(const std::string& target) {
+  // A reader going away shows up as a failed write, not a signal
+  std::signal(SIGPIPE, SIG_IGN);
+  if (target == "-") {
+    fd_ = STDOUT_FILENO;
+    return true;
+  }
+  owns_fd_ = true;
+  const std::string unix_prefix{"unix:"};
+  if (target.compare(0, unix_prefix.size(), unix_prefix) == 0) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::string path = target.substr(unix_prefix.size());
+    if (path.size() >= sizeof(address.sun_path)) {
+      return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd_ >= 0 && connect(fd_, reinterpret_cast<sockaddr*>(&address),
+                            sizeof(address)) != 0) {
+      close(fd_);
+      fd_ = -1;
+    }
+  } else {
+    fd_ = open(target.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+               0644);
+  }
+  return fd_ >= 0;
+}
+
+// One write() per record; partial writes (sockets, pipes) are completed
+bool Exporter::Write(const Snapshot& snapshot) {
+  INSTRUMENT_STAGE(kExport);
+  size_ = 0;
+  if (encoding_ == Encoding::kJsonLines) {
+    EncodeJson(snapshot);
+  } else {
+    EncodeBinary(snapshot);
+  }
+  const char* data = buffer_.data();
+  std::size_t left = size_;
+  while (left > 0) {
+    ssize_t written = write(fd_, data, left);
+    INSTRUMENT_SYSCALLS(1);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    data += written;
+    left -= written;
+  }
+  return true;
+}
+
+void Exporter::CpuBudget(double share) { cpu_budget_ = std::max(share, 0.0); }
+
+namespace {
+// CPU time of every thread of the monitor
+double ProcessCpuMilliseconds() {
+  timespec time;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+  return time.tv_sec * 1e3 + time.tv_nsec / 1e6;
+}
+}  // namespace
+
+int Exporter::Run(System& system, int n, std::chrono::milliseconds interval,
+                  History* history, PressureTrigger* trigger) {
+  system.MemoryDetail(false);
+  system.ThreadView(false);
+  Collector collector(system, n, interval);
+  collector.Record(history);
+  collector.WatchPressure(trigger);
+  interval = collector.Interval();
+  Snapshot snapshot;
+  // Milliseconds of CPU per tick, smoothed. The first tick reads every
+  // process's command line and user, so it does not count.
+  double cost = -1.0;
+  while (true) {
+    double start = ProcessCpuMilliseconds();
+    collector.CollectNow(snapshot);
+    if (!Write(snapshot)) {
+      return 1;
+    }
+    double used = ProcessCpuMilliseconds() - start;
+    if (cost < 0.0) {
+      cost = 0.0;
+    } else {
+      cost = cost == 0.0 ? used : 0.75 * cost + 0.25 * used;
+    }
+    if (cpu_budget_ > 0.0) {
+      auto affordable =
+          std::chrono::milliseconds(std::llround(cost / cpu_budget_));
+      collector.Interval(std::max(interval, affordable));
+    }
+    collector.WaitForTick();
+  }
+}
+
+// The buffer only grows, so once it fits the largest record no tick
+// allocates
+char* Exporter::Reserve(std::size_t size) {
+  if (size_ + size > buffer_.size()) {
+    buffer_.resize(std::max(buffer_.size() * 2, size_ + size));
+  }
+  char* position = buffer_.data() + size_;
+  size_ += size;
+  return position;
+}
+
+void Exporter::Append(std::string_view text) {
+  std::memcpy(Reserve(text.size()), text.data(), text.size());
+}
+
+// JSON has no NaN or infinity, so those are written as null
+template <typename T>
+void Exporter::AppendNumber(T value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    if (!std::isfinite(value)) {
+      Append("null");
+      return;
+    }
+  }
+  char digits[32];
+  auto result = std::to_chars(digits, digits + sizeof(digits), value);
+  Append(std::string_view(digits, result.ptr - digits));
+}
+
+namespace {
+// Length of the well-formed UTF-8 sequence starting at text[i], or 0 if
+// none does. Overlong forms, surrogates and code points past U+10FFFF are
+// not well formed.
+std::size_t Utf8Length(std::string_view text, std::size_t i) {
+  auto byte = [&](std::size_t j) {
+    return j < text.size() ? static_cast<unsigned char>(text[j]) : 0u;
+  };
+  unsigned lead = byte(i);
+  std::size_t length;
+  unsigned low = 0x80, high = 0xbf;  // range of the second byte
+  if (lead >= 0xc2 && lead <= 0xdf) {
+    length = 2;
+  } else if (lead >= 0xe0 && lead <= 0xef) {
+    length = 3;
+    if (lead == 0xe0) low = 0xa0;
+    if (lead == 0xed) high = 0x9f;
+  } else if (lead >= 0xf0 && lead <= 0xf4) {
+    length = 4;
+    if (lead == 0xf0) low = 0x90;
+    if (lead == 0xf4) high = 0x8f;
+  } else {
+    return 0;
+  }
+  if (byte(i + 1) < low || byte(i + 1) > high) {
+    return 0;
+  }
+  for (std::size_t j = i + 2; j < i + length; ++j) {
+    if (byte(j) < 0x80 || byte(j) > 0xbf) {
+      return 0;
+    }
+  }
+  return length;
+}
+}  // namespace
+
+// Command lines, user and disk names are bytes, not necessarily UTF-8;
+// bytes that are not part of a well-formed sequence are written as U+FFFD
+// so that the line stays valid JSON
+void Exporter::AppendString(std::string_view text) {
+  Append("\"");
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    char c = text[i];
+    if (static_cast<unsigned char>(c) >= 0x80) {
+      std::size_t length = Utf8Length(text, i);
+      if (length == 0) {
+        Append("\\ufffd");
+      } else {
+        Append(text.substr(i, length));
+        i += length - 1;
+      }
+      continue;
+    }
+    switch (c) {
+      case '"':
+        Append("\\\"");
+        break;
+      case '\\':
+        Append("\\\\");
+        break;
+      case '\n':
+        Append("\\n");
+        break;
+      case '\t':
+        Append("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          static const char hex[] = "0123456789abcdef";
+          char escape[] = {'\\', 'u', '0', '0', hex[(c >> 4) & 0xf],
+                           hex[c & 0xf]};
+          Append(std::string_view(escape, sizeof(escape)));
+        } else {
+          *Reserve(1) = c;
+        }
+    }
+  }
+  Append("\"");
+}
+
+template <typename T>
+void Exporter::AppendRaw(T value) {
+  std::memcpy(Reserve(sizeof(value)), &value, sizeof(value));
+}
+
+void Exporter::AppendRawString(std::string_view text) {
+  auto length = static_cast<std::uint16_t>(
+      std::min<std::size_t>(text.size(), UINT16_MAX));
+  AppendRaw(length);
+  std::memcpy(Reserve(length), text.data(), length);
+}
+
+void Exporter::EncodeJson(const Snapshot& snapshot) {
+  Append("{\"seq\":");
+  AppendNumber(snapshot.sequence);
+  Append(",\"ts\":");
+  AppendNumber(snapshot.timestamp_ms);
+  Append(",\"cpu\":");
+  AppendNumber(snapshot.cpu);
+  Append(",\"cores\":[");
+  for (std::size_t i = 0; i < snapshot.cores.size(); ++i) {
+    if (i > 0) Append(",");
+    AppendNumber(snapshot.cores[i]);
+  }
+  Append("],\"mem\":");
+  AppendNumber(snapshot.memory);
+  Append(",\"cache\":");
+  AppendNumber(snapshot.cache);
+  Append(",\"swap\":");
+  AppendNumber(snapshot.swap);
+  Append(",\"disks\":[");
+  for (std::size_t i = 0; i < snapshot.disks.size(); ++i) {
+    const DiskRate& disk = snapshot.disks[i];
+    Append(i > 0 ? ",{\"name\":" : "{\"name\":");
+    AppendString(disk.name);
+    Append(",\"read_bps\":");
+    AppendNumber(disk.read_bps);
+    Append(",\"write_bps\":");
+    AppendNumber(disk.write_bps);
+    Append(",\"util\":");
+    AppendNumber(disk.utilization);
+    Append("}");
+  }
+  Append("],\"load\":[");
+  AppendNumber(snapshot.load.one);
+  Append(",");
+  AppendNumber(snapshot.load.five);
+  Append(",");
+  AppendNumber(snapshot.load.fifteen);
+  Append("]");
+  if (snapshot.has_pressure) {
+    Append(",\"psi\":{");
+    for (auto [name, pressure] :
+         {std::pair{"\"cpu\":{\"some\":", &snapshot.cpu_pressure},
+          std::pair{",\"mem\":{\"some\":", &snapshot.memory_pressure},
+          std::pair{",\"io\":{\"some\":", &snapshot.io_pressure}}) {
+      Append(name);
+      AppendNumber(pressure->some.avg10);
+      Append(",\"full\":");
+      AppendNumber(pressure->full.avg10);
+      Append("}");
+    }
+    Append("}");
+  }
+  Append(",\"procs\":");
+  AppendNumber(snapshot.total_processes);
+  Append(",\"running\":");
+  AppendNumber(snapshot.running_processes);
+  Append(",\"uptime\":");
+  AppendNumber(snapshot.uptime);
+  Append(",\"top\":[");
+  for (std::size_t i = 0; i < snapshot.processes.size(); ++i) {
+    const Process& process = snapshot.processes[i];
+    Append(i > 0 ? ",{\"pid\":" : "{\"pid\":");
+    AppendNumber(process.Pid());
+    Append(",\"ppid\":");
+    AppendNumber(process.ParentPid());
+    Append(",\"user\":");
+    AppendString(process.User());
+    Append(",\"cpu\":");
+    AppendNumber(process.CpuUtilization());
+    Append(",\"ram_mb\":");
+    AppendNumber(process.RamMegabytes());
+    if (process.HasIo()) {
+      Append(",\"read_bps\":");
+      AppendNumber(process.ReadRate());
+      Append(",\"write_bps\":");
+      AppendNumber(process.WriteRate());
+    }
+    Append(",\"uptime\":");
+    AppendNumber(process.UpTime());
+    Append(",\"cmd\":");
+    AppendString(process.Command());
+    Append("}");
+  }
+  Append("]");
+  if (snapshot.group_view) {
+    Append(",\"cgroups\":[");
+    for (std::size_t i = 0; i < snapshot.cgroups.size(); ++i) {
+      const CgroupUsage& group = snapshot.cgroups[i];
+      Append(i > 0 ? ",{\"path\":" : "{\"path\":");
+      AppendString(group.path);
+      Append(",\"procs\":");
+      AppendNumber(group.processes);
+      Append(",\"cpu\":");
+      AppendNumber(group.cpu);
+      Append(",\"mem_mb\":");
+      AppendNumber(group.memory_kb / 1024);
+      if (group.has_io) {
+        Append(",\"read_bps\":");
+        AppendNumber(group.read_bps);
+        Append(",\"write_bps\":");
+        AppendNumber(group.write_bps);
+      }
+      Append("}");
+    }
+    Append("]");
+  }
+  Append(",\"exited\":[");
+  for (std::size_t i = 0; i < snapshot.exited.size(); ++i) {
+    const System::ExitedProcess& exited = snapshot.exited[i];
+    Append(i > 0 ? ",{\"pid\":" : "{\"pid\":");
+    AppendNumber(exited.pid);
+    Append(",\"cmd\":");
+    AppendString(exited.command);
+    Append(",\"jiffies\":");
+    AppendNumber(exited.cpu_jiffies);
+    Append("}");
+  }
+  Append("]");
+  if (snapshot.instrumented) {
+    const Instrument::Counters& cost = snapshot.cost;
+    Append(",\"self\":{\"syscalls\":");
+    AppendNumber(cost.syscalls);
+    Append(",\"bytes_read\":");
+    AppendNumber(cost.bytes_read);
+    Append(",\"allocs\":");
+    AppendNumber(cost.allocations);
+    for (int stage = 0; stage < Instrument::kStages; ++stage) {
+      Append(",\"");
+      Append(Instrument::StageName(Instrument::Stage(stage)));
+      Append("\":{\"wall_ns\":");
+      AppendNumber(cost.wall_ns[stage]);
+      Append(",\"cpu_ns\":");
+      AppendNumber(cost.cpu_ns[stage]);
+      Append("}");
+    }
+    Append("}");
+  }
+  Append("}\n");
+}
+
+void Exporter::EncodeBinary(const Snapshot& snapshot) {
+  AppendRaw(std::uint32_t{0});  // length, patched below
+  AppendRaw(kBinaryMagic);
+  AppendRaw(std::uint64_t(snapshot.sequence));
+  AppendRaw(std::int64_t(snapshot.timestamp_ms));
+  AppendRaw(snapshot.cpu);
+  AppendRaw(snapshot.memory);
+  AppendRaw(snapshot.cache);
+  AppendRaw(snapshot.swap);
+  AppendRaw(std::int32_t(snapshot.total_processes));
+  AppendRaw(std::int32_t(snapshot.running_processes));
+  AppendRaw(std::int64_t(snapshot.uptime));
+  AppendRaw(std::uint32_t(snapshot.cores.size()));
+  for (float core : snapshot.cores) {
+    AppendRaw(core);
+  }
+  AppendRaw(std::uint32_t(snapshot.disks.size()));
+  for (const DiskRate& disk : snapshot.disks) {
+    AppendRawString(disk.name);
+    AppendRaw(disk.read_bps);
+    AppendRaw(disk.write_bps);
+    AppendRaw(disk.utilization);
+  }
+  AppendRaw(snapshot.load.one);
+  AppendRaw(snapshot.load.five);
+  AppendRaw(snapshot.load.fifteen);
+  AppendRaw(std::uint32_t(snapshot.has_pressure ? 1 : 0));
+  if (snapshot.has_pressure) {
+    for (const Pressure* pressure :
+         {&snapshot.cpu_pressure, &snapshot.memory_pressure,
+          &snapshot.io_pressure}) {
+      AppendRaw(pressure->some.avg10);
+      AppendRaw(pressure->full.avg10);
+    }
+  }
+  AppendRaw(std::uint32_t(snapshot.processes.size()));
+  for (const Process& process : snapshot.processes) {
+    AppendRaw(std::int32_t(process.Pid()));
+    AppendRaw(std::int32_t(process.ParentPid()));
+    AppendRaw(process.CpuUtilization());
+    AppendRaw(std::uint64_t(process.RamMegabytes()));
+    AppendRaw(process.HasIo() ? process.ReadRate() : -1.0f);
+    AppendRaw(process.HasIo() ? process.WriteRate() : -1.0f);
+    AppendRaw(std::int64_t(process.UpTime()));
+    AppendRawString(process.User());
+    AppendRawString(process.Command());
+  }
+  AppendRaw(std::uint32_t(snapshot.cgroups.size()));
+  for (const CgroupUsage& group : snapshot.cgroups) {
+    AppendRawString(group.path);
+    AppendRaw(std::int32_t(group.processes));
+    AppendRaw(group.cpu);
+    AppendRaw(std::uint64_t(group.memory_kb / 1024));
+    AppendRaw(group.has_io ? group.read_bps : -1.0f);
+    AppendRaw(group.has_io ? group.write_bps : -1.0f);
+  }
+  AppendRaw(std::uint32_t(snapshot.exited.size()));
+  for (const System::ExitedProcess& exited : snapshot.exited) {
+    AppendRaw(std::int32_t(exited.pid));
+    AppendRaw(std::uint64_t(exited.cpu_jiffies));
+    AppendRawString(exited.command);
+  }
+  AppendRaw(std::uint32_t(snapshot.instrumented ? 1 : 0));
+  if (snapshot.instrumented) {
+    const Instrument::Counters& cost = snapshot.cost;
+    AppendRaw(std::uint64_t(cost.syscalls));
+    AppendRaw(std::uint64_t(cost.bytes_read));
+    AppendRaw(std::uint64_t(cost.allocations));
+    for (int stage = 0; stage < Instrument::kStages; ++stage) {
+      AppendRaw(std::uint64_t(cost.wall_ns[stage]));
+      AppendRaw(std::uint64_t(cost.cpu_ns[stage]));
+    }
+  }
+  auto length = static_cast<std::uint32_t>(size_ - sizeof(std::uint32_t));
+  std::memcpy(buffer_.data(), &length, sizeof(length));
+}
@@ -1,7 +1,9 @@
 #include "format.h"
 
 #include <string>
+#include <cstdio>
 #include <iomanip>
+#include <sstream>
 
 using std::string;
 
@@ -45,4 +47,25 @@ string Format::ElapsedTime(long seconds ) {
 
     return ss.str();
    */
-}
\ No newline at end of file
+}
+
+void Format::ElapsedTime(long seconds, char* buffer, std::size_t size) {
+    std::snprintf(buffer, size, "%02ld:%02ld:%02ld", seconds / 3600,
+                  (seconds % 3600) / 60, seconds % 60);
+}
+
+void Format::Bytes(double bytes, char* buffer, std::size_t size) {
+    static const char units[] = "KMGTP";
+    if (bytes < 1024.0) {
+        std::snprintf(buffer, size, "%.0f", bytes);
+        return;
+    }
+    int unit = 0;
+    bytes /= 1024.0;
+    while (bytes >= 1024.0 && units[unit + 1] != '\0') {
+        bytes /= 1024.0;
+        ++unit;
+    }
+    std::snprintf(buffer, size, bytes < 100.0 ? "%.1f%c" : "%.0f%c", bytes,
+                  units[unit]);
+}
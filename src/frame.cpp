@@ -0,0 +1,82 @@
+#include "frame.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+// `previous_` starts out as zeros, which no drawn cell is equal to, so the
+// first Flush() paints the whole interior
+Frame::Frame(WINDOW* window)
+    : window_(window),
+      rows_(getmaxy(window)),
+      columns_(getmaxx(window)),
+      current_(rows_ * columns_, 0),
+      previous_(rows_ * columns_, 0) {
+  box(window_, 0, 0);
+  Clear();
+}
+
+int Frame::Rows() const { return rows_; }
+
+int Frame::Columns() const { return columns_; }
+
+bool Frame::Inside(int row, int column) const {
+  return row > 0 && row < rows_ - 1 && column > 0 && column < columns_ - 1;
+}
+
+void Frame::Clear() {
+  for (int row = 1; row < rows_ - 1; ++row) {
+    for (int column = 1; column < columns_ - 1; ++column) {
+      current_[row * columns_ + column] = ' ';
+    }
+  }
+}
+
+void Frame::ClearRow(int row) {
+  for (int column = 1; column < columns_ - 1; ++column) {
+    Put(row, column, ' ');
+  }
+}
+
+void Frame::Put(int row, int column, chtype cell) {
+  if (Inside(row, column)) {
+    current_[row * columns_ + column] = cell;
+  }
+}
+
+// Text is clipped at the right border
+void Frame::Print(int row, int column, const char* text, chtype attributes) {
+  for (; *text != '\0' && column < columns_ - 1; ++text, ++column) {
+    Put(row, column, static_cast<unsigned char>(*text) | attributes);
+  }
+}
+
+void Frame::Printf(int row, int column, chtype attributes, const char* format,
+                   ...) {
+  va_list arguments;
+  va_start(arguments, format);
+  vsnprintf(buffer_, sizeof(buffer_), format, arguments);
+  va_end(arguments);
+  Print(row, column, buffer_, attributes);
+}
+
+// Hand every run of changed cells to ncurses in one call
+void Frame::Flush() {
+  for (int row = 1; row < rows_ - 1; ++row) {
+    const chtype* current = &current_[row * columns_];
+    chtype* previous = &previous_[row * columns_];
+    int column = 1;
+    while (column < columns_ - 1) {
+      if (current[column] == previous[column]) {
+        ++column;
+        continue;
+      }
+      int start = column;
+      while (column < columns_ - 1 && current[column] != previous[column]) {
+        previous[column] = current[column];
+        ++column;
+      }
+      mvwaddchnstr(window_, row, start, current + start, column - start);
+    }
+  }
+  wnoutrefresh(window_);
+}
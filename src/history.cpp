@@ -0,0 +1,251 @@
+#include "history.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+#include <thread>
+
+#include "linux_parser.h"
+
+namespace {
+const char kMagic[8] = {'M', 'O', 'N', 'H', 'I', 'S', 'T', '1'};
+// 2: system rows beyond CPU and memory; 3: record stamps
+const std::uint32_t kVersion = 3;
+
+void CopyString(char* target, std::size_t size, std::string_view source) {
+  std::size_t length = std::min(source.size(), size - 1);
+  std::memcpy(target, source.data(), length);
+  std::memset(target + length, 0, size - length);
+}
+}  // namespace
+
+History::~History() {
+  if (mapping_ != nullptr) {
+    munmap(mapping_, size_);
+  }
+}
+
+bool History::Map(int fd, std::size_t size, bool writable) {
+  int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+  void* mapping = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+  mapping_ = mapping;
+  size_ = size;
+  header_ = static_cast<Header*>(mapping);
+  return true;
+}
+
+bool History::Create(const std::string& path, std::size_t capacity) {
+  capacity = std::max<std::size_t>(capacity, 1);
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  std::size_t size = kHeaderSize + capacity * sizeof(Record);
+  struct stat info {};
+  Layout existing{};
+  bool reuse = fstat(fd, &info) == 0 &&
+               static_cast<std::size_t>(info.st_size) == size &&
+               pread(fd, &existing, sizeof(existing), 0) ==
+                   static_cast<ssize_t>(sizeof(existing)) &&
+               std::memcmp(existing.magic, kMagic, sizeof(kMagic)) == 0 &&
+               existing.version == kVersion &&
+               existing.record_size == sizeof(Record) &&
+               existing.capacity == capacity;
+  // The file is sparse: pages are only allocated as records are written
+  if (!reuse && (ftruncate(fd, 0) != 0 || ftruncate(fd, size) != 0)) {
+    close(fd);
+    return false;
+  }
+  if (!Map(fd, size, true)) {
+    return false;
+  }
+  if (!reuse) {
+    Layout& layout = header_->layout;
+    std::memcpy(layout.magic, kMagic, sizeof(kMagic));
+    layout.version = kVersion;
+    layout.record_size = sizeof(Record);
+    layout.capacity = capacity;
+    layout.clock_ticks = LinuxParser::ClockTicks();
+    layout.top = kTop;
+    header_->written.store(0);
+  }
+  return true;
+}
+
+bool History::Open(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info {};
+  if (fstat(fd, &info) != 0 ||
+      static_cast<std::size_t>(info.st_size) < kHeaderSize) {
+    close(fd);
+    return false;
+  }
+  if (!Map(fd, info.st_size, false)) {
+    return false;
+  }
+  const Layout& layout = header_->layout;
+  bool valid = std::memcmp(layout.magic, kMagic, sizeof(kMagic)) == 0 &&
+               layout.version == kVersion &&
+               layout.record_size == sizeof(Record) && layout.capacity > 0 &&
+               kHeaderSize + layout.capacity * sizeof(Record) <= size_;
+  if (!valid) {
+    munmap(mapping_, size_);
+    mapping_ = nullptr;
+    header_ = nullptr;
+  }
+  return valid;
+}
+
+History::Record* History::Slot(std::uint64_t position) const {
+  char* records = static_cast<char*>(mapping_) + kHeaderSize;
+  return reinterpret_cast<Record*>(records) +
+         position % header_->layout.capacity;
+}
+
+// The record is complete before the count is published, so a reader of the
+// same file never sees a half written newest record; the stamp covers the
+// oldest one, which is overwritten in place
+void History::Append(const Snapshot& snapshot) {
+  if (header_ == nullptr) {
+    return;
+  }
+  std::uint64_t position = header_->written.load(std::memory_order_relaxed);
+  Record& record = *Slot(position);
+  __atomic_store_n(&record.stamp, 2 * position + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  record.sequence = snapshot.sequence;
+  record.timestamp_ms = snapshot.timestamp_ms;
+  record.interval_ms =
+      last_timestamp_ > 0 ? snapshot.timestamp_ms - last_timestamp_ : 0;
+  last_timestamp_ = snapshot.timestamp_ms;
+  record.cpu = snapshot.cpu;
+  record.breakdown = snapshot.breakdown;
+  record.memory = snapshot.memory;
+  record.cache = snapshot.cache;
+  record.swap = snapshot.swap;
+  record.disk_count = std::min<std::size_t>(snapshot.disks.size(), kDisks);
+  std::copy_n(snapshot.disks.begin(), record.disk_count, record.disks);
+  record.load[0] = snapshot.load.one;
+  record.load[1] = snapshot.load.five;
+  record.load[2] = snapshot.load.fifteen;
+  record.runnable = snapshot.load.runnable;
+  record.entities = snapshot.load.total;
+  record.has_pressure = snapshot.has_pressure;
+  const Pressure* pressures[] = {&snapshot.cpu_pressure,
+                                 &snapshot.memory_pressure,
+                                 &snapshot.io_pressure};
+  for (int i = 0; i < 3; ++i) {
+    record.pressure[i][0] = pressures[i]->some.avg10;
+    record.pressure[i][1] = pressures[i]->some.avg60;
+    record.pressure[i][2] = pressures[i]->some.avg300;
+    record.pressure[i][3] = pressures[i]->full.avg10;
+  }
+  record.total_processes = snapshot.total_processes;
+  record.running_processes = snapshot.running_processes;
+  record.uptime = snapshot.uptime;
+  record.count = std::min<std::size_t>(snapshot.processes.size(), kTop);
+  for (std::uint32_t i = 0; i < record.count; ++i) {
+    const Process& process = snapshot.processes[i];
+    record.pid[i] = process.Pid();
+    record.jiffies[i] = process.IntervalJiffies();
+    record.ram_mb[i] = process.RamMegabytes();
+    record.start[i] = snapshot.uptime - process.UpTime();
+    CopyString(record.user[i], kUserLength, process.User());
+    CopyString(record.command[i], kCommandLength, process.Command());
+  }
+  __atomic_store_n(&record.stamp, 2 * position + 2, __ATOMIC_RELEASE);
+  header_->written.store(position + 1, std::memory_order_release);
+}
+
+std::size_t History::Size() const {
+  if (header_ == nullptr) {
+    return 0;
+  }
+  return std::min<std::uint64_t>(
+      header_->written.load(std::memory_order_acquire),
+      header_->layout.capacity);
+}
+
+// A writer that died halfway through a record leaves its stamp odd; after
+// kRetries attempts that record is returned as it is
+History::Record History::At(std::size_t index) const {
+  constexpr int kRetries = 1000;
+  std::uint64_t written = header_->written.load(std::memory_order_acquire);
+  std::uint64_t oldest = written - Size();
+  const Record& slot = *Slot(oldest + index);
+  Record copy;
+  for (int attempt = 0; attempt < kRetries; ++attempt) {
+    std::uint64_t before = __atomic_load_n(&slot.stamp, __ATOMIC_ACQUIRE);
+    std::memcpy(&copy, &slot, sizeof(copy));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    std::uint64_t after = __atomic_load_n(&slot.stamp, __ATOMIC_RELAXED);
+    if (before == after && before % 2 == 0) {
+      break;
+    }
+    std::this_thread::yield();
+  }
+  return copy;
+}
+
+void History::Load(std::size_t index, Snapshot& snapshot) const {
+  const Record record = At(index);
+  snapshot.sequence = record.sequence;
+  snapshot.timestamp_ms = record.timestamp_ms;
+  snapshot.cpu = record.cpu;
+  snapshot.breakdown = record.breakdown;
+  snapshot.cores.clear();
+  snapshot.memory = record.memory;
+  snapshot.cache = record.cache;
+  snapshot.swap = record.swap;
+  snapshot.disks.assign(
+      record.disks,
+      record.disks + std::min<std::uint32_t>(record.disk_count, kDisks));
+  snapshot.load.one = record.load[0];
+  snapshot.load.five = record.load[1];
+  snapshot.load.fifteen = record.load[2];
+  snapshot.load.runnable = record.runnable;
+  snapshot.load.total = record.entities;
+  snapshot.has_pressure = record.has_pressure != 0;
+  Pressure* pressures[] = {&snapshot.cpu_pressure, &snapshot.memory_pressure,
+                           &snapshot.io_pressure};
+  for (int i = 0; i < 3; ++i) {
+    *pressures[i] = {};
+    pressures[i]->some.avg10 = record.pressure[i][0];
+    pressures[i]->some.avg60 = record.pressure[i][1];
+    pressures[i]->some.avg300 = record.pressure[i][2];
+    pressures[i]->full.avg10 = record.pressure[i][3];
+  }
+  snapshot.total_processes = record.total_processes;
+  snapshot.running_processes = record.running_processes;
+  snapshot.uptime = record.uptime;
+  snapshot.exited.clear();
+  snapshot.latency = {};
+  snapshot.processes.clear();
+  float seconds = record.interval_ms / 1000.0f;
+  for (std::uint32_t i = 0; i < std::min<std::uint32_t>(record.count, kTop);
+       ++i) {
+    float cpu =
+        seconds > 0.0f
+            ? record.jiffies[i] / (seconds * header_->layout.clock_ticks)
+            : 0.0f;
+    snapshot.processes.emplace_back(
+        record.pid[i],
+        std::string_view(record.user[i], strnlen(record.user[i], kUserLength)),
+        std::string_view(record.command[i],
+                         strnlen(record.command[i], kCommandLength)),
+        cpu, record.ram_mb[i], record.start[i], record.uptime);
+  }
+}
@@ -0,0 +1,183 @@
+#include "instrument.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using std::uint64_t;
+
+namespace {
+std::atomic<bool> enabled{false};
+}  // namespace
+
+Instrument::Counters Instrument::Counters::operator-(
+    const Counters& other) const {
+  Counters difference;
+  difference.syscalls = syscalls - other.syscalls;
+  difference.bytes_read = bytes_read - other.bytes_read;
+  difference.allocations = allocations - other.allocations;
+  for (int stage = 0; stage < kStages; ++stage) {
+    difference.wall_ns[stage] = wall_ns[stage] - other.wall_ns[stage];
+    difference.cpu_ns[stage] = cpu_ns[stage] - other.cpu_ns[stage];
+  }
+  return difference;
+}
+
+const char* Instrument::StageName(Stage stage) {
+  static const char* const names[kStages] = {"collect", "sort", "render",
+                                             "export"};
+  return names[stage];
+}
+
+void Instrument::SetEnabled(bool value) {
+  enabled.store(value && kCompiled, std::memory_order_relaxed);
+}
+
+bool Instrument::Enabled() { return enabled.load(std::memory_order_relaxed); }
+
+#if MONITOR_INSTRUMENT
+namespace {
+uint64_t Nanoseconds(const timespec& time) {
+  return uint64_t(time.tv_sec) * 1000000000ULL + time.tv_nsec;
+}
+
+// Written only by the owning thread, read by Totals() from any thread.
+// Constant initialized with a trivial destructor, so touching it (even from
+// operator new) runs no constructor.
+struct alignas(64) ThreadCounters {
+  std::atomic<uint64_t> syscalls{0};
+  std::atomic<uint64_t> bytes_read{0};
+  std::atomic<uint64_t> allocations{0};
+  std::atomic<uint64_t> wall_ns[Instrument::kStages]{};
+  std::atomic<uint64_t> cpu_ns[Instrument::kStages]{};
+};
+
+// Single writer, so a plain load and store is enough; no locked add
+void Add(std::atomic<uint64_t>& counter, uint64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+}
+
+void Accumulate(Instrument::Counters& totals, const ThreadCounters& counters) {
+  totals.syscalls += counters.syscalls.load(std::memory_order_relaxed);
+  totals.bytes_read += counters.bytes_read.load(std::memory_order_relaxed);
+  totals.allocations += counters.allocations.load(std::memory_order_relaxed);
+  for (int stage = 0; stage < Instrument::kStages; ++stage) {
+    totals.wall_ns[stage] +=
+        counters.wall_ns[stage].load(std::memory_order_relaxed);
+    totals.cpu_ns[stage] +=
+        counters.cpu_ns[stage].load(std::memory_order_relaxed);
+  }
+}
+
+std::mutex registry_mutex;
+// Never destroyed: threads may still exit after static destructors run.
+// Built in static storage rather than with new: an allocation here would
+// be counted, which registers the thread, which needs the registry.
+std::vector<ThreadCounters*>& Registry() {
+  alignas(std::vector<ThreadCounters*>) static unsigned char
+      storage[sizeof(std::vector<ThreadCounters*>)];
+  static auto* registry = new (storage) std::vector<ThreadCounters*>;
+  return *registry;
+}
+Instrument::Counters retired;  // Counts of threads that have exited
+
+thread_local ThreadCounters local;
+thread_local bool registered{false};
+thread_local unsigned timing{0};  // Stages being timed on this thread
+
+// Folds the thread's counts into `retired` when the thread exits
+struct Registration {
+  ~Registration() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    Accumulate(retired, local);
+    auto& registry = Registry();
+    for (auto it = registry.begin(); it != registry.end(); ++it) {
+      if (*it == &local) {
+        registry.erase(it);
+        break;
+      }
+    }
+  }
+};
+thread_local Registration registration;
+
+// The flag is set first: registering allocates, which comes back here
+ThreadCounters& Local() {
+  if (!registered) {
+    registered = true;
+    (void)&registration;
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    Registry().push_back(&local);
+  }
+  return local;
+}
+}  // namespace
+
+Instrument::Counters Instrument::Totals() {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  Counters totals = retired;
+  for (const ThreadCounters* counters : Registry()) {
+    Accumulate(totals, *counters);
+  }
+  return totals;
+}
+
+void Instrument::CountSyscalls(unsigned count) {
+  if (Enabled()) Add(Local().syscalls, count);
+}
+
+void Instrument::CountRead(std::size_t bytes) {
+  if (Enabled()) Add(Local().bytes_read, bytes);
+}
+
+Instrument::StageTimer::StageTimer(Stage stage, bool wall)
+    : stage_(stage),
+      active_(Enabled() && (timing & (1u << stage)) == 0),
+      wall_(wall),
+      wall_start_{},
+      cpu_start_{} {
+  if (!active_) return;
+  timing |= 1u << stage_;
+  clock_gettime(CLOCK_MONOTONIC, &wall_start_);
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start_);
+}
+
+Instrument::StageTimer::~StageTimer() {
+  if (!active_) return;
+  timespec wall_end, cpu_end;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+  clock_gettime(CLOCK_MONOTONIC, &wall_end);
+  timing &= ~(1u << stage_);
+  ThreadCounters& counters = Local();
+  Add(counters.cpu_ns[stage_], Nanoseconds(cpu_end) - Nanoseconds(cpu_start_));
+  if (wall_) {
+    Add(counters.wall_ns[stage_],
+        Nanoseconds(wall_end) - Nanoseconds(wall_start_));
+  }
+}
+
+// Every heap allocation in the program passes through here
+void* operator new(std::size_t size) {
+  if (Instrument::Enabled()) Add(Local().allocations, 1);
+  if (size == 0) size = 1;
+  while (true) {
+    if (void* memory = std::malloc(size)) return memory;
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) throw std::bad_alloc();
+    handler();
+  }
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+#else
+Instrument::Counters Instrument::Totals() { return Counters(); }
+#endif
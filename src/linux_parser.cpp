@@ -1,326 +1,554 @@
 #include "linux_parser.h"
 
-#include <dirent.h>
+#include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 
-using std::stof;
+#include "instrument.h"
+#include "proc_reader.h"
+#include "user_cache.h"
+
+using ProcReader::FieldScanner;
 using std::string;
+using std::string_view;
 using std::to_string;
 using std::vector;
 
 // DONE: An example of how to read data from the filesystem
 string LinuxParser::OperatingSystem() {
-  string line;
-  string key;
-  string value;
-  std::ifstream filestream(kOSPath);
-  if (filestream.is_open()) {
-    while (std::getline(filestream, line)) {
-      std::replace(line.begin(), line.end(), ' ', '_');
-      std::replace(line.begin(), line.end(), '=', ' ');
-      std::replace(line.begin(), line.end(), '"', ' ');
-      std::istringstream linestream(line);
-      while (linestream >> key >> value) {
-        if (key == filterOperatingSystem) {
-          std::replace(value.begin(), value.end(), '_', ' ');
-          return value;
-        }
-      }
-    }
-    filestream.close();
+  string_view contents;
+  if (!ProcReader::ReadPath(kOSPath, contents)) {
+    return "";
   }
-  return value;
+  // PRETTY_NAME="Debian GNU/Linux 12 (bookworm)"
+  string_view line = ProcReader::FindValue(contents, filterOperatingSystem);
+  if (!line.empty() && line.front() == '=') line.remove_prefix(1);
+  if (!line.empty() && line.front() == '"') line.remove_prefix(1);
+  if (!line.empty() && line.back() == '"') line.remove_suffix(1);
+  return string(line);
 }
 
 // DONE: An example of how to read data from the filesystem
 string LinuxParser::Kernel() {
-  string os, version, kernel;
-  string line;
-  std::ifstream stream(kProcDirectory + kVersionFilename);
-  if (stream.is_open()) {
-    std::getline(stream, line);
-    std::istringstream linestream(line);
-    linestream >> os >> version >> kernel;
-
-    stream.close();
+  string_view contents;
+  if (!ProcReader::Read(kVersionFilename, contents)) {
+    return "";
   }
-  return kernel;
+  // Linux version <kernel> ...
+  FieldScanner fields(contents);
+  fields.Skip(2);
+  return string(fields.NextToken());
 }
 
 // BONUS: Update this to use std::filesystem
+// The /proc directory is opened once and rewound on every call; its entries
+// are read with getdents64 into a buffer that is kept between calls.
 vector<int> LinuxParser::Pids() {
+  static std::mutex mutex;
+  static const int fd =
+      open(kProcDirectory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
   vector<int> pids;
-  DIR* directory = opendir(kProcDirectory.c_str());
-  struct dirent* file;
-  while ((file = readdir(directory)) != nullptr) {
-    // Is this a directory?
-    if (file->d_type == DT_DIR) {
-      // Is every character of the name a digit?
-      string filename(file->d_name);
-      if (std::all_of(filename.begin(), filename.end(), isdigit)) {
-        int pid = stoi(filename);
-        pids.push_back(pid);
-      }
-    }
+  std::lock_guard<std::mutex> lock(mutex);
+  INSTRUMENT_SYSCALLS(1);  // lseek
+  if (fd < 0 || lseek(fd, 0, SEEK_SET) != 0) {
+    return pids;
   }
-  closedir(directory);
+  pids.reserve(1024);
+  ProcReader::ReadIds(fd, pids);
   return pids;
 }
 
-// Read and return the system memory utilization
-float LinuxParser::MemoryUtilization() {
-  std::ifstream filestream(kProcDirectory + kMeminfoFilename);
-  string line;
-  string name, memory, units;
-  float memoryTotal, memoryFree;
-  float memoryUtilization{0};
-  if (filestream.is_open()) {
-    std::getline(filestream, line);
-    std::istringstream linestream(line);
-    linestream >> name >> memory >> units;  // MemTotal
-    memoryTotal = std::stoi(memory);
-    std::getline(filestream, line);
-    linestream.clear();
-    linestream.str(line);
-    linestream >> name >> memory >> units;  // MemFree
-    memoryFree = std::stoi(memory);
-
-    memoryUtilization = (memoryTotal - memoryFree) / memoryTotal;
-
-    filestream.close();
+namespace {
+using MemInfoField = long LinuxParser::MemInfo::*;
+
+// The MemInfo field for a /proc/meminfo key, or nullptr. The first
+// character narrows the key down to a handful of candidates.
+MemInfoField MemInfoKey(string_view key) {
+  using M = LinuxParser::MemInfo;
+  if (key.empty()) return nullptr;
+  switch (key[0]) {
+    case 'A':
+      if (key == "Active") return &M::active;
+      if (key == "AnonPages") return &M::anon_pages;
+      break;
+    case 'B':
+      if (key == "Buffers") return &M::buffers;
+      break;
+    case 'C':
+      if (key == "Cached") return &M::cached;
+      if (key == "CommitLimit") return &M::commit_limit;
+      if (key == "Committed_AS") return &M::committed_as;
+      break;
+    case 'D':
+      if (key == "Dirty") return &M::dirty;
+      break;
+    case 'H':
+      if (key == "HugePages_Total") return &M::huge_pages_total;
+      if (key == "HugePages_Free") return &M::huge_pages_free;
+      if (key == "Hugepagesize") return &M::huge_page_size;
+      break;
+    case 'I':
+      if (key == "Inactive") return &M::inactive;
+      break;
+    case 'K':
+      if (key == "KernelStack") return &M::kernel_stack;
+      break;
+    case 'M':
+      if (key == "MemTotal") return &M::mem_total;
+      if (key == "MemFree") return &M::mem_free;
+      if (key == "MemAvailable") return &M::mem_available;
+      if (key == "Mapped") return &M::mapped;
+      break;
+    case 'P':
+      if (key == "PageTables") return &M::page_tables;
+      break;
+    case 'S':
+      if (key == "SwapCached") return &M::swap_cached;
+      if (key == "SwapTotal") return &M::swap_total;
+      if (key == "SwapFree") return &M::swap_free;
+      if (key == "Shmem") return &M::shmem;
+      if (key == "Slab") return &M::slab;
+      if (key == "SReclaimable") return &M::s_reclaimable;
+      if (key == "SUnreclaim") return &M::s_unreclaim;
+      break;
+    case 'W':
+      if (key == "Writeback") return &M::writeback;
+      break;
   }
+  return nullptr;
+}
+}  // namespace
+
+long LinuxParser::MemInfo::CacheKilobytes() const {
+  return std::max(0L, cached + s_reclaimable - shmem);
+}
+
+long LinuxParser::MemInfo::UsedKilobytes() const {
+  if (mem_available >= 0) {
+    return mem_total - mem_available;
+  }
+  return std::max(0L, mem_total - mem_free - buffers - CacheKilobytes());
+}
 
-  return memoryUtilization;
+float LinuxParser::MemInfo::Used() const {
+  return mem_total > 0 ? float(UsedKilobytes()) / mem_total : 0.0f;
+}
+
+float LinuxParser::MemInfo::Cache() const {
+  return mem_total > 0 ? float(buffers + CacheKilobytes()) / mem_total
+                       : 0.0f;
+}
+
+float LinuxParser::MemInfo::Swap() const {
+  return swap_total > 0 ? float(swap_total - swap_free) / swap_total : 0.0f;
+}
+
+// Lines are "Key:   value kB"
+void LinuxParser::ParseMemInfo(string_view contents, MemInfo& info) {
+  while (!contents.empty()) {
+    std::size_t next = contents.find('\n');
+    string_view line = contents.substr(0, next);
+    contents.remove_prefix(next == string_view::npos ? contents.size()
+                                                     : next + 1);
+    std::size_t colon = line.find(':');
+    if (colon == string_view::npos) continue;
+    if (MemInfoField field = MemInfoKey(line.substr(0, colon))) {
+      FieldScanner(line.substr(colon + 1)).Next(info.*field);
+    }
+  }
+}
+
+bool LinuxParser::ReadMemInfo(MemInfo& info) {
+  string_view contents;
+  if (!ProcReader::Read(kMeminfoFilename, contents)) {
+    return false;
+  }
+  ParseMemInfo(contents, info);
+  return true;
+}
+
+// Read and return the system memory utilization. Page cache and other
+// memory the kernel can reclaim on demand does not count as used.
+float LinuxParser::MemoryUtilization() {
+  MemInfo info;
+  if (!ReadMemInfo(info)) {
+    return 0.0f;
+  }
+  return info.Used();
 }
 
 // Read and return the system uptime
 long LinuxParser::UpTime() {
-  string line;
-  string key;
-  string time {""};
-  std::ifstream filestream(kProcDirectory + kUptimeFilename);
-  if (filestream.is_open()) {
-    std::getline(filestream, line);
-    std::istringstream linestream(line);
-    linestream >> time;
-
-    filestream.close();
+  string_view contents;
+  long uptime = 0;
+  if (ProcReader::Read(kUptimeFilename, contents)) {
+    // Fractional seconds are dropped, as before
+    FieldScanner(contents).Next(uptime);
   }
-  return std::stol(time);
+  return uptime;
 }
 
 // Read and return the number of jiffies for the system
-long LinuxParser::Jiffies() { 
+long LinuxParser::Jiffies() {
   return  ActiveJiffies() + IdleJiffies();
 }
 
 // Read and return the number of active jiffies for a PID
-long LinuxParser::ActiveJiffies(int pid) { 
-
+long LinuxParser::ActiveJiffies(int pid) {
   // https://stackoverflow.com/questions/39066998/what-are-the-meaning-of-values-at-proc-pid-stat
-  long int utime, stime, cutime, cstime;
-  long activeJiffies {-1};
-  std::ifstream filestream(kProcDirectory + std::to_string(pid) + kStatFilename);
-  if(filestream.is_open())
-  {
-    string line, useless_token;
-    std::getline(filestream, line);
-    std::istringstream linestream(line);
-
-    for(int i = 0; i < 13; ++i)
-    {
-      linestream >> useless_token;
-    }
-
-    // 14 -> utime, 15 -> stime, 16 -> cutime, 17-> cstime
-    linestream >> utime >> stime >> cutime >> cstime;
-
-    activeJiffies = (utime + stime + cutime + cstime) / sysconf(_SC_CLK_TCK);
-
-    filestream.close();
+  ProcStatSnapshot stat;
+  if (!ReadProcStat(pid, stat)) {
+    return -1;
   }
+  return (stat.utime + stat.stime + stat.cutime + stat.cstime) / ClockTicks();
+}
 
-  return activeJiffies; 
+namespace {
+// The aggregate "cpu" line of /proc/stat as numbers
+std::array<long, 10> CpuJiffies() {
+  std::array<long, 10> jiffies{};
+  string_view contents;
+  if (ProcReader::Read(LinuxParser::kStatFilename, contents)) {
+    FieldScanner fields(ProcReader::FindValue(contents, "cpu"));
+    for (long& value : jiffies) {
+      fields.Next(value);
+    }
+  }
+  return jiffies;
 }
+}  // namespace
 
 // Read and return the number of active jiffies for the system
 long LinuxParser::ActiveJiffies() {
-  auto jiffies = CpuUtilization();
+  auto jiffies = CpuJiffies();
 
-  return std::stol(jiffies[CPUStates::kUser_]) +
-         std::stol(jiffies[CPUStates::kNice_]) +
-         std::stol(jiffies[CPUStates::kSystem_]) +
-         std::stol(jiffies[CPUStates::kIRQ_]) +
-         std::stol(jiffies[CPUStates::kSoftIRQ_]) +
-         std::stol(jiffies[CPUStates::kSteal_]);
+  return jiffies[CPUStates::kUser_] + jiffies[CPUStates::kNice_] +
+         jiffies[CPUStates::kSystem_] + jiffies[CPUStates::kIRQ_] +
+         jiffies[CPUStates::kSoftIRQ_] + jiffies[CPUStates::kSteal_];
 }
 
 // Read and return the number of idle jiffies for the system
 long LinuxParser::IdleJiffies() {
-  auto jiffies = CpuUtilization();
+  auto jiffies = CpuJiffies();
 
-  return std::stol(jiffies[CPUStates::kIdle_]) +
-         std::stol(jiffies[CPUStates::kIOwait_]);
+  return jiffies[CPUStates::kIdle_] + jiffies[CPUStates::kIOwait_];
 }
 
 // Read and return CPU utilization
 vector<string> LinuxParser::CpuUtilization() {
-  string line, cpu, value;
   vector<string> jiffies;
-  std::ifstream stream(kProcDirectory + kStatFilename);
-
-  if (stream.is_open()) {
-    std::getline(stream, line);
-    std::istringstream linestream(line);
-
-    linestream >> cpu;
-
-    while (linestream >> value) {
-      jiffies.push_back(value);
+  string_view contents;
+  if (ProcReader::Read(kStatFilename, contents)) {
+    FieldScanner fields(ProcReader::FindValue(contents, "cpu"));
+    for (string_view value = fields.NextToken(); !value.empty();
+         value = fields.NextToken()) {
+      jiffies.emplace_back(value);
     }
-    stream.close();
   }
-
   return jiffies;
 }
 
-// helper function to find a value by its key in a file.
-// the structure of the file must be: key value
-string findValueInFileByKey(string path, string formatedKey) {
-  string line;
-  string key;
-  string value;
-  std::ifstream filestream(path);
-  if (filestream.is_open()) {
-    while (std::getline(filestream, line)) {
-      std::istringstream linestream(line);
-      while (linestream >> key >> value) {
-        if (key == formatedKey) {
-          return value;
-        }
-      }
-    }
-    filestream.close();
-  }
-
-  return "";
-}
-
 // Read and return the total number of processes
 int LinuxParser::TotalProcesses() {
-  string value =
-      findValueInFileByKey(kProcDirectory + kStatFilename, filterProcesses);
-  if (!value.empty()) {
-    return std::stoi(value);
-  } else {
-    return 0;
+  string_view contents;
+  int value = 0;
+  if (ProcReader::Read(kStatFilename, contents)) {
+    FieldScanner(ProcReader::FindValue(contents, filterProcesses)).Next(value);
   }
+  return value;
 }
 
 // Read and return the number of running processes
 int LinuxParser::RunningProcesses() {
-  string value =
-      findValueInFileByKey(kProcDirectory + kStatFilename, filterRunningProcesses);
-  if (!value.empty()) {
-    return std::stoi(value);
-  } else {
-    return 0;
+  string_view contents;
+  int value = 0;
+  if (ProcReader::Read(kStatFilename, contents)) {
+    FieldScanner(ProcReader::FindValue(contents, filterRunningProcesses))
+        .Next(value);
   }
+  return value;
+}
+
+// Read and return the thread IDs of a process
+vector<int> LinuxParser::Tids(int pid, std::size_t limit) {
+  vector<int> tids;
+  ProcReader::ListIds(pid, kTaskDirectory, tids, limit);
+  return tids;
 }
 
 // Read and return the command associated with a process
-string LinuxParser::Command(int pid) { 
-  string command {""};
-  std::ifstream filestream(kProcDirectory + std::to_string(pid) + kCmdlineFilename);
-  if(filestream.is_open())
-  {
-    string line;
-    std::getline(filestream, line);
-    std::istringstream linestream(line);
-    linestream >> command;
-
-    filestream.close();
+string LinuxParser::Command(int pid) {
+  string_view contents;
+  if (!ProcReader::Read(pid, kCmdlineFilename, contents)) {
+    return "";
   }
-
-  return command; 
-  
+  // Arguments are NUL separated (and the last one NUL terminated); they
+  // are joined with spaces
+  while (!contents.empty() && contents.back() == '\0') {
+    contents.remove_suffix(1);
+  }
+  string command(contents);
+  std::replace(command.begin(), command.end(), '\0', ' ');
+  return command;
 }
 
 // Read and return the memory used by a process
 string LinuxParser::Ram(int pid) {
   // VmSize is the sum of all the virtual memory
   // VmRSS gives the exact physical memory being used as a part of Physical RAM
-  // following the Udacity guidelines, It is used VmSize 
+  // VmSize says little for processes that reserve far more than they use,
+  // so VmRSS is reported
+  ProcStatusSnapshot status;
+  ReadProcStatus(pid, status);
+  return std::to_string(status.vm_rss_kb / 1024);
+}
 
-  string vmSize = findValueInFileByKey(kProcDirectory + std::to_string(pid) + kStatusFilename, filterProcMem);
-  int ram = 0;
-  if(!vmSize.empty())
-  {
-    ram = std::stof(vmSize)/ 1024;
+// Read and return the user ID associated with a process
+string LinuxParser::Uid(int pid) {
+  ProcStatusSnapshot status;
+  if (!ReadProcStatus(pid, status) || status.uid < 0) {
+    return "";
   }
+  return std::to_string(status.uid);
+}
 
+// Read and return the user associated with a process
+string LinuxParser::User(int pid) {
+  static UserCache users;
+  ProcStatusSnapshot status;
+  if (!ReadProcStatus(pid, status) || status.uid < 0) {
+    return "Unknown";
+  }
+  users.Refresh();
+  return string(users.Name(status.uid).View());
+}
 
-  return std::to_string(ram);
+// Read and return the uptime of a process
+long LinuxParser::UpTime(int pid) {
+  // The 22nd field in this file contains the process start time in jiffies
+  ProcStatSnapshot stat;
+  if (!ReadProcStat(pid, stat)) {
+    return 0;
+  }
+  return stat.starttime / ClockTicks();
 }
 
-// Read and return the user ID associated with a process
-string LinuxParser::Uid(int pid) { 
-  string uid = findValueInFileByKey(kProcDirectory + std::to_string(pid) + kStatusFilename, filterUID);
-  return uid;
+// Page size in bytes, queried once
+long LinuxParser::PageSize() {
+  static const long size = sysconf(_SC_PAGESIZE);
+  return size;
 }
 
-// Read and return the user associated with a process
-string LinuxParser::User(int pid) { 
-  //https://www.cyberciti.biz/faq/understanding-etcpasswd-file-format/
-  string user_uid = Uid(pid);
-  string name {"Unkonwn"};
-  if(user_uid.empty())
-  {
-    return name;
+// Clock ticks per second, queried once
+long LinuxParser::ClockTicks() {
+  static const long ticks = sysconf(_SC_CLK_TCK);
+  return ticks;
+}
+
+// Parse a /proc/[pid]/stat line. The command name (field 2) is wrapped in
+// parentheses and may itself contain spaces or ')', so the fixed fields are
+// located from the last ')' in the line.
+bool LinuxParser::ParseProcStat(const char* data, std::size_t size,
+                                ProcStatSnapshot& snapshot) {
+  const char* end = data + size;
+  const char* open = static_cast<const char*>(std::memchr(data, '(', size));
+  const char* close = static_cast<const char*>(memrchr(data, ')', size));
+  if (open == nullptr || close == nullptr || close < open) {
+    return false;
   }
 
-  std::ifstream filestream(kPasswordPath);
-  
-  if (filestream.is_open()) {
-    string line, pass, uid;
-    while (std::getline(filestream, line)) {
-      std::replace(line.begin(), line.end(), ':', ' ');
-      std::istringstream linestream(line);
-      while (linestream >> name >> pass >> uid) {
-        if (uid == user_uid) {
-          return name;
-        }
-      }
-    }
-    filestream.close();
+  FieldScanner head(data, open);
+  head.Next(snapshot.pid);
+  std::size_t comm_length = std::min<std::size_t>(
+      close - open - 1, sizeof(snapshot.comm) - 1);
+  std::memcpy(snapshot.comm, open + 1, comm_length);
+  snapshot.comm[comm_length] = '\0';
+
+  // Fields 3 onwards
+  FieldScanner scanner(close + 1, end);
+  unsigned long cminflt, cmajflt;
+  scanner.Next(snapshot.state);      // 3
+  scanner.Next(snapshot.ppid);       // 4
+  scanner.Next(snapshot.pgrp);       // 5
+  scanner.Next(snapshot.session);    // 6
+  scanner.Skip(3);                   // 7 tty_nr, 8 tpgid, 9 flags
+  scanner.Next(snapshot.minflt);     // 10
+  scanner.Next(cminflt);             // 11
+  scanner.Next(snapshot.majflt);     // 12
+  scanner.Next(cmajflt);             // 13
+  scanner.Next(snapshot.utime);      // 14
+  scanner.Next(snapshot.stime);      // 15
+  scanner.Next(snapshot.cutime);     // 16
+  scanner.Next(snapshot.cstime);     // 17
+  scanner.Next(snapshot.priority);   // 18
+  scanner.Next(snapshot.nice);       // 19
+  scanner.Next(snapshot.num_threads);  // 20
+  scanner.Skip(1);                   // 21 itrealvalue
+  scanner.Next(snapshot.starttime);  // 22
+  scanner.Next(snapshot.vsize);      // 23
+  scanner.Next(snapshot.rss);        // 24
+  scanner.Skip(14);                  // 25 rsslim ... 38 exit_signal
+  scanner.Next(snapshot.processor);  // 39
+  return true;
+}
+
+// Read /proc/[pid]/stat with a single read()
+bool LinuxParser::ReadProcStat(int pid, ProcStatSnapshot& snapshot) {
+  string_view contents;
+  if (!ProcReader::Read(pid, kStatFilename, contents)) {
+    return false;
   }
+  return ParseProcStat(contents.data(), contents.size(), snapshot);
+}
 
-  return name;
+bool LinuxParser::ReadTaskStat(int pid, int tid, ProcStatSnapshot& snapshot) {
+  string_view contents;
+  if (!ProcReader::Read(pid, tid, kStatFilename, contents)) {
+    return false;
+  }
+  return ParseProcStat(contents.data(), contents.size(), snapshot);
 }
 
-// Read and return the uptime of a process
-long LinuxParser::UpTime(int pid) { 
-  // The 22nd field in this file contains the process start time in jiffies (1/100th of a second).
-  long int uptime {0};
-  std::ifstream filestream(kProcDirectory + std::to_string(pid) + kStatFilename);
-  if(filestream.is_open())
-  {
-    string line;
-    std::getline(filestream, line);
-    std::istringstream linestream(line);
-    std::string field;
-    for (int i = 1; i <= 22; ++i) {
-      linestream >> field;
+// Read /proc/[pid]/status with a single read() and pick out the fields
+// needed, one line at a time
+bool LinuxParser::ReadProcStatus(int pid, ProcStatusSnapshot& snapshot) {
+  string_view contents;
+  if (!ProcReader::Read(pid, kStatusFilename, contents)) {
+    return false;
+  }
+
+  while (!contents.empty()) {
+    std::size_t next = contents.find('\n');
+    string_view line = contents.substr(0, next);
+    contents.remove_prefix(next == string_view::npos ? contents.size()
+                                                     : next + 1);
+    std::size_t colon = line.find(':');
+    if (colon == string_view::npos) continue;
+    string_view key = line.substr(0, colon);
+    FieldScanner value(line.substr(colon + 1));
+    if (key == "Uid") {
+      value.Next(snapshot.uid);
+    } else if (key == "VmSize") {
+      value.Next(snapshot.vm_size_kb);
+    } else if (key == "VmRSS") {
+      value.Next(snapshot.vm_rss_kb);
+    }
+  }
+  return true;
+}
+
+bool LinuxParser::ReadSmapsRollup(int pid, SmapsRollupSnapshot& snapshot) {
+  string_view contents;
+  if (!ProcReader::Read(pid, kSmapsRollupFilename, contents)) {
+    return false;
+  }
+
+  // The first line names the address range; the rest are "Key: value kB"
+  snapshot = SmapsRollupSnapshot();
+  long private_clean = 0, private_dirty = 0;
+  while (!contents.empty()) {
+    std::size_t next = contents.find('\n');
+    string_view line = contents.substr(0, next);
+    contents.remove_prefix(next == string_view::npos ? contents.size()
+                                                     : next + 1);
+    std::size_t colon = line.find(':');
+    if (colon == string_view::npos) continue;
+    string_view key = line.substr(0, colon);
+    FieldScanner value(line.substr(colon + 1));
+    if (key == "Rss") {
+      value.Next(snapshot.rss_kb);
+    } else if (key == "Pss") {
+      value.Next(snapshot.pss_kb);
+    } else if (key == "Private_Clean") {
+      value.Next(private_clean);
+    } else if (key == "Private_Dirty") {
+      value.Next(private_dirty);
+    } else if (key == "Swap") {
+      value.Next(snapshot.swap_kb);
     }
+  }
+  snapshot.uss_kb = private_clean + private_dirty;
+  return true;
+}
+
+bool LinuxParser::ReadProcIo(int pid, ProcIoSnapshot& snapshot) {
+  string_view contents;
+  if (!ProcReader::Read(pid, kIoFilename, contents)) {
+    return false;
+  }
+  FieldScanner(ProcReader::FindValue(contents, "read_bytes:"))
+      .Next(snapshot.read_bytes);
+  FieldScanner(ProcReader::FindValue(contents, "write_bytes:"))
+      .Next(snapshot.write_bytes);
+  return true;
+}
+
+string LinuxParser::Cgroup(int pid) {
+  string_view contents;
+  if (!ProcReader::Read(pid, kCgroupFilename, contents)) {
+    return "";
+  }
+  // "0::/system.slice/sshd.service"; v1 hierarchies have other IDs
+  string_view path = ProcReader::FindValue(contents, "0::");
+  return string(path);
+}
 
-    uptime = std::stol(field) / sysconf(_SC_CLK_TCK);
+string LinuxParser::CgroupRoot() {
+  static const string root = [] {
+    if (!kCgroupDirectory.empty()) return kCgroupDirectory;
+    string_view contents;
+    if (ProcReader::Read(kMountsFilename, contents)) {
+      // "cgroup2 /sys/fs/cgroup/unified cgroup2 rw,relatime 0 0"
+      while (!contents.empty()) {
+        std::size_t next = contents.find('\n');
+        FieldScanner fields(contents.substr(0, next));
+        contents.remove_prefix(next == string_view::npos ? contents.size()
+                                                         : next + 1);
+        fields.Skip(1);
+        string_view mount_point = fields.NextToken();
+        if (fields.NextToken() == "cgroup2") return string(mount_point);
+      }
+    }
+    return string("/sys/fs/cgroup");
+  }();
+  return root;
+}
 
-    filestream.close();
+bool LinuxParser::ReadCgroup(const string& directory,
+                             CgroupCounters& counters) {
+  counters = CgroupCounters();
+  string_view contents;
+  if (!ProcReader::ReadPath(directory + "/cpu.stat", contents)) {
+    return false;  // removed, or not a cgroup
+  }
+  FieldScanner(ProcReader::FindValue(contents, "usage_usec"))
+      .Next(counters.usage_usec);
+  if (ProcReader::ReadPath(directory + "/memory.current", contents)) {
+    FieldScanner(contents).Next(counters.memory_bytes);
+  }
+  if (ProcReader::ReadPath(directory + "/io.stat", contents)) {
+    // "8:0 rbytes=1 wbytes=2 rios=3 wios=4 dbytes=0 dios=0" per device
+    counters.read_bytes = counters.write_bytes = 0;
+    FieldScanner fields(contents);
+    for (string_view field = fields.NextToken(); !field.empty();
+         field = fields.NextToken()) {
+      long long value = 0;
+      if (field.compare(0, 7, "rbytes=") == 0) {
+        FieldScanner(field.substr(7)).Next(value);
+        counters.read_bytes += value;
+      } else if (field.compare(0, 7, "wbytes=") == 0) {
+        FieldScanner(field.substr(7)).Next(value);
+        counters.write_bytes += value;
+      }
+    }
   }
-  
-  return uptime; 
-  
+  return true;
 }
@@ -1,7 +1,182 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "exporter.h"
+#include "instrument.h"
 #include "ncurses_display.h"
 #include "system.h"
 
-int main() {
-  System system;
-  NCursesDisplay::Display(system);
-}
\ No newline at end of file
+namespace {
+void Usage(const char* program) {
+  std::fprintf(stderr,
+               "usage: %s [--proc-events] [--interval MS] [--top N] [--self]\n"
+               "          [--threads] [--cgroups] [--tree] [--psi-trigger]\n"
+               "          [--sort cpu|mem|io] [--min-cpu PERCENT] "
+               "[--user NAME]\n"
+               "          [--command LINE]\n"
+               "          [--record FILE [--history-size RECORDS]]\n"
+               "          [--headless [--format json|binary] "
+               "[--output -|FILE|unix:PATH]\n"
+               "                      [--cpu-budget PERCENT]]\n"
+               "       %s --replay FILE [--top N]\n",
+               program, program);
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  bool proc_events = false;
+  bool headless = false;
+  bool threads = false;
+  bool cgroups = false;
+  bool tree = false;
+  auto sort = System::SortOrder::kCpu;
+  float min_cpu = 0.0f;
+  std::string user;
+  std::string command;
+  auto encoding = Exporter::Encoding::kJsonLines;
+  std::string output{"-"};
+  double cpu_budget = Exporter::kCpuBudget;
+  // Unless given, 1 s, or 5 s with --psi-trigger
+  std::chrono::milliseconds interval{0};
+  bool psi_trigger = false;
+  int n = 10;
+  std::string record;
+  std::string replay;
+  std::size_t history_size = 24 * 60 * 60;  // a day at one tick per second
+  for (int i = 1; i < argc; ++i) {
+    const char* argument = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+    // Track process lifecycle through the kernel proc connector
+    if (std::strcmp(argument, "--proc-events") == 0) {
+      proc_events = true;
+    } else if (std::strcmp(argument, "--self") == 0) {
+      // Measure the monitor's own cost from the start ('s' toggles it)
+      Instrument::SetEnabled(true);
+    } else if (std::strcmp(argument, "--threads") == 0) {
+      // Show the busiest threads of each listed process ('t' toggles it)
+      threads = true;
+    } else if (std::strcmp(argument, "--tree") == 0) {
+      // Show the process tree ('T' toggles it, '+' and '-' expand and
+      // collapse a level)
+      tree = true;
+    } else if (std::strcmp(argument, "--cgroups") == 0) {
+      // List cgroups instead of processes ('g' toggles it)
+      cgroups = true;
+    } else if (std::strcmp(argument, "--sort") == 0 && value) {
+      // Rank by resident memory or storage I/O instead of CPU ('c', 'm'
+      // and 'i' switch between them)
+      if (std::strcmp(value, "mem") == 0) {
+        sort = System::SortOrder::kMemory;
+      } else if (std::strcmp(value, "io") == 0) {
+        sort = System::SortOrder::kIo;
+      } else if (std::strcmp(value, "cpu") != 0) {
+        Usage(argv[0]);
+        return 2;
+      }
+      ++i;
+    } else if (std::strcmp(argument, "--min-cpu") == 0 && value) {
+      // Hide processes using less CPU than this, in percent of one core
+      min_cpu = std::max(0.0, std::atof(value)) / 100;
+      ++i;
+    } else if (std::strcmp(argument, "--user") == 0 && value) {
+      // Only list the processes of this user
+      user = value;
+      ++i;
+    } else if (std::strcmp(argument, "--command") == 0 && value) {
+      // Only list the processes running exactly this command line
+      command = value;
+      ++i;
+    } else if (std::strcmp(argument, "--psi-trigger") == 0) {
+      // Sample slowly, and every 250 ms while CPU, memory or I/O pressure
+      // is high
+      psi_trigger = true;
+    } else if (std::strcmp(argument, "--headless") == 0) {
+      headless = true;
+    } else if (std::strcmp(argument, "--format") == 0 && value) {
+      if (std::strcmp(value, "binary") == 0) {
+        encoding = Exporter::Encoding::kBinary;
+      } else if (std::strcmp(value, "json") != 0) {
+        Usage(argv[0]);
+        return 2;
+      }
+      ++i;
+    } else if (std::strcmp(argument, "--output") == 0 && value) {
+      output = value;
+      ++i;
+    } else if (std::strcmp(argument, "--cpu-budget") == 0 && value) {
+      // Share of one core headless mode may use, in percent; ticks are
+      // spaced out to stay within it. 0 turns the limit off.
+      cpu_budget = std::max(0.0, std::atof(value)) / 100;
+      ++i;
+    } else if (std::strcmp(argument, "--interval") == 0 && value) {
+      interval = std::chrono::milliseconds(std::max(1, std::atoi(value)));
+      ++i;
+    } else if (std::strcmp(argument, "--top") == 0 && value) {
+      n = std::max(0, std::atoi(value));
+      ++i;
+    } else if (std::strcmp(argument, "--record") == 0 && value) {
+      record = value;
+      ++i;
+    } else if (std::strcmp(argument, "--history-size") == 0 && value) {
+      history_size = std::max(1, std::atoi(value));
+      ++i;
+    } else if (std::strcmp(argument, "--replay") == 0 && value) {
+      replay = value;
+      ++i;
+    } else {
+      Usage(argv[0]);
+      return 2;
+    }
+  }
+
+  History history;
+  if (!replay.empty()) {
+    if (!history.Open(replay)) {
+      std::fprintf(stderr, "%s: not a history file\n", replay.c_str());
+      return 1;
+    }
+    NCursesDisplay::Replay(history, n);
+    return 0;
+  }
+  if (!record.empty() && !history.Create(record, history_size)) {
+    std::perror(record.c_str());
+    return 1;
+  }
+  History* recording = record.empty() ? nullptr : &history;
+
+  // Trigger when tasks stalled for 10% of a one second window. Without
+  // triggers the monitor still runs, at the slow interval.
+  PressureTrigger trigger;
+  if (psi_trigger &&
+      !trigger.Arm(std::chrono::milliseconds(100), std::chrono::seconds(1))) {
+    std::fprintf(stderr, "--psi-trigger: no trigger could be armed: %s\n",
+                 std::strerror(errno));
+  }
+  if (interval.count() == 0) {
+    interval = std::chrono::seconds(psi_trigger ? 5 : 1);
+  }
+
+  System system(std::thread::hardware_concurrency(), proc_events);
+  system.ThreadView(threads);
+  system.GroupView(cgroups);
+  system.TreeView(tree);
+  system.Sort(sort);
+  system.Filter(min_cpu, user, command);
+  if (headless) {
+    Exporter exporter(encoding);
+    exporter.CpuBudget(cpu_budget);
+    if (!exporter.Open(output)) {
+      std::perror(output.c_str());
+      return 1;
+    }
+    return exporter.Run(system, n, interval, recording,
+                        psi_trigger ? &trigger : nullptr);
+  }
+  NCursesDisplay::Display(system, n, interval, recording,
+                          psi_trigger ? &trigger : nullptr);
+}
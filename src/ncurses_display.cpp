@@ -2,111 +2,550 @@
 
 #include <curses.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <memory>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include "collector.h"
 #include "format.h"
+#include "instrument.h"
 #include "system.h"
 
 using std::string;
-using std::to_string;
+
+// Column where bars and the core strip start
+namespace {
+int const kBarColumn{10};
+}
 
 // 50 bars uniformly displayed from 0 - 100 %
 // 2% is one bar(|)
-std::string NCursesDisplay::ProgressBar(float percent) {
-  std::string result{"0%"};
+void NCursesDisplay::ProgressBar(Frame& frame, int row, int column,
+                                 float percent) {
+  chtype const color = COLOR_PAIR(1);
   int size{50};
   float bars{percent * size};
 
+  frame.Print(row, column, "0%", color);
+  column += 2;
   for (int i{0}; i < size; ++i) {
-    result += i <= bars ? '|' : ' ';
+    frame.Put(row, column++, (i <= bars ? '|' : ' ') | color);
+  }
+  if (percent >= 1.0f) {
+    frame.Print(row, column, "  100/100%", color);
+  } else {
+    frame.Printf(row, column, color, " %4.1f/100%%", percent * 100);
   }
+}
 
-  string display{to_string(percent * 100).substr(0, 4)};
-  if (percent < 0.1 || percent == 1.0)
-    display = " " + to_string(percent * 100).substr(0, 3);
-  return result + " " + display + "/100%";
+// Rows the strip needs at one character per core
+int NCursesDisplay::HeatStripRows(std::size_t cores, int columns) {
+  int width = columns - kBarColumn - 2;
+  if (cores == 0 || width <= 0) return 0;
+  return (int(cores) + width - 1) / width;
 }
 
-void NCursesDisplay::DisplaySystem(System& system, WINDOW* window) {
+// One character per core: the glyph gets denser and the color moves from
+// green to red as the core gets busier
+void NCursesDisplay::HeatStrip(const std::vector<float>& cores, Frame& frame,
+                               int& row) {
+  static const char glyphs[] = "_.:-=+*#%@";
+  int width = frame.Columns() - kBarColumn - 2;
+  for (std::size_t core = 0; core < cores.size(); ++core) {
+    int column = core % width;
+    if (column == 0) {
+      ++row;
+      if (core == 0) frame.Print(row, 2, "Cores: ");
+    }
+    float load = cores[core];
+    int level = std::min(9, int(load * 10));
+    int color = load < 0.5f ? 3 : load < 0.8f ? 4 : 5;
+    frame.Put(row, kBarColumn + column, glyphs[level] | COLOR_PAIR(color));
+  }
+}
+
+// Read and write rate and utilization of each disk, on one row; disks that
+// do not fit are left out
+void NCursesDisplay::DisplayDisks(const std::vector<DiskRate>& disks,
+                                  Frame& frame, int row) {
+  frame.Print(row, 2, "Disk: ");
+  int column = kBarColumn;
+  char read[16], write[16];
+  for (const DiskRate& disk : disks) {
+    Format::Bytes(disk.read_bps, read, sizeof(read));
+    Format::Bytes(disk.write_bps, write, sizeof(write));
+    char text[96];
+    int length = std::snprintf(text, sizeof(text), "%s r %s/s w %s/s %.0f%%",
+                               disk.name, read, write,
+                               disk.utilization * 100);
+    if (column + length >= frame.Columns() - 1) break;
+    frame.Print(row, column, text);
+    column += length + 3;
+  }
+}
+
+namespace {
+// Stall share over the last 10 seconds, colored like the core strip
+void PrintStall(Frame& frame, int row, int& column, float percent) {
+  int color = percent < 5.0f ? 3 : percent < 20.0f ? 4 : 5;
+  frame.Printf(row, column, COLOR_PAIR(color), "%5.1f%%", percent);
+  column += 6;
+}
+}  // namespace
+
+// some/full avg10 of each resource, and the slower averages of "some" to
+// tell a spike from a trend
+void NCursesDisplay::DisplayPressure(const Snapshot& snapshot, Frame& frame,
+                                     int row) {
+  frame.Print(row, 2, "PSI: ");
+  if (!snapshot.has_pressure) {
+    frame.Print(row, kBarColumn, "not available", A_DIM);
+    return;
+  }
+  int column = kBarColumn;
+  for (auto [name, pressure] :
+       {std::pair{"cpu", &snapshot.cpu_pressure},
+        std::pair{"mem", &snapshot.memory_pressure},
+        std::pair{"io", &snapshot.io_pressure}}) {
+    frame.Print(row, column, name);
+    column += 4;
+    PrintStall(frame, row, column, pressure->some.avg10);
+    frame.Put(row, column++, '/');
+    PrintStall(frame, row, column, pressure->full.avg10);
+    frame.Printf(row, column, A_DIM, " (%.1f %.1f)", pressure->some.avg60,
+                 pressure->some.avg300);
+    column += 16;
+  }
+}
+
+void NCursesDisplay::DisplaySystem(Snapshot& snapshot, Frame& frame) {
   int row{0};
-  mvwprintw(window, ++row, 2, ("OS: " + system.OperatingSystem()).c_str());
-  mvwprintw(window, ++row, 2, ("Kernel: " + system.Kernel()).c_str());
-  mvwprintw(window, ++row, 2, "CPU: ");
-  wattron(window, COLOR_PAIR(1));
-  mvwprintw(window, row, 10, "");
-  wprintw(window, ProgressBar(system.Cpu().Utilization()).c_str());
-  wattroff(window, COLOR_PAIR(1));
-  mvwprintw(window, ++row, 2, "Memory: ");
-  wattron(window, COLOR_PAIR(1));
-  mvwprintw(window, row, 10, "");
-  wprintw(window, ProgressBar(system.MemoryUtilization()).c_str());
-  wattroff(window, COLOR_PAIR(1));
-  mvwprintw(window, ++row, 2,
-            ("Total Processes: " + to_string(system.TotalProcesses())).c_str());
-  mvwprintw(
-      window, ++row, 2,
-      ("Running Processes: " + to_string(system.RunningProcesses())).c_str());
-  mvwprintw(window, ++row, 2,
-            ("Up Time: " + Format::ElapsedTime(system.UpTime())).c_str());
-  wrefresh(window);
+  frame.Printf(++row, 2, A_NORMAL, "OS: %s",
+               snapshot.operating_system.c_str());
+  frame.Printf(++row, 2, A_NORMAL, "Kernel: %s", snapshot.kernel.c_str());
+  frame.Print(++row, 2, "CPU: ");
+  ProgressBar(frame, row, kBarColumn, snapshot.cpu);
+  const CpuBreakdown& breakdown = snapshot.breakdown;
+  frame.Printf(++row, kBarColumn, A_NORMAL,
+               "usr %5.1f%%  sys %5.1f%%  irq %5.1f%%  steal %5.1f%%  "
+               "iowait %5.1f%%",
+               breakdown.user * 100, breakdown.system * 100,
+               breakdown.irq * 100, breakdown.steal * 100,
+               breakdown.iowait * 100);
+  HeatStrip(snapshot.cores, frame, row);
+  frame.Print(++row, 2, "Memory: ");
+  ProgressBar(frame, row, kBarColumn, snapshot.memory);
+  frame.Print(++row, 2, "Cache: ");
+  ProgressBar(frame, row, kBarColumn, snapshot.cache);
+  frame.Print(++row, 2, "Swap: ");
+  ProgressBar(frame, row, kBarColumn, snapshot.swap);
+  DisplayDisks(snapshot.disks, frame, ++row);
+  const LoadAverage& load = snapshot.load;
+  frame.Printf(++row, 2, A_NORMAL, "Load:   %.2f %.2f %.2f  (%d/%d runnable)",
+               load.one, load.five, load.fifteen, load.runnable, load.total);
+  DisplayPressure(snapshot, frame, ++row);
+  frame.Printf(++row, 2, A_NORMAL, "Total Processes: %d",
+               snapshot.total_processes);
+  frame.Printf(++row, 2, A_NORMAL, "Running Processes: %d",
+               snapshot.running_processes);
+  char uptime[32];
+  Format::ElapsedTime(snapshot.uptime, uptime, sizeof(uptime));
+  frame.Printf(++row, 2, A_NORMAL, "Up Time: %s", uptime);
+  if (Instrument::kCompiled) {
+    ++row;
+    if (snapshot.instrumented) {
+      const Instrument::Counters& cost = snapshot.cost;
+      auto ms = [](std::uint64_t ns) { return ns / 1e6; };
+      frame.Printf(row, 2, A_DIM,
+                   "Self: %lu syscalls  %.1f KiB  %lu allocs  |  wall/cpu ms: "
+                   "collect %.1f/%.1f  sort %.2f/%.2f  render %.2f/%.2f",
+                   static_cast<unsigned long>(cost.syscalls),
+                   cost.bytes_read / 1024.0,
+                   static_cast<unsigned long>(cost.allocations),
+                   ms(cost.wall_ns[Instrument::kCollect]),
+                   ms(cost.cpu_ns[Instrument::kCollect]),
+                   ms(cost.wall_ns[Instrument::kSort]),
+                   ms(cost.cpu_ns[Instrument::kSort]),
+                   ms(cost.wall_ns[Instrument::kRender]),
+                   ms(cost.cpu_ns[Instrument::kRender]));
+    }
+  }
+  const StageLatency& latency = snapshot.latency;
+  frame.Printf(++row, 2, A_DIM,
+               "Tick: every %lld ms  collect %.1f ms  sort %.2f ms  "
+               "render %.2f ms",
+               snapshot.interval_ms, latency.collect, latency.sort,
+               latency.render);
 }
 
+namespace {
+// Bytes per second, or "-" when unknown
+void PrintRate(Frame& frame, int row, int column, float rate, bool known) {
+  if (known) {
+    char text[16];
+    Format::Bytes(rate, text, sizeof(text));
+    frame.Print(row, column, text);
+  } else {
+    frame.Print(row, column, "-", A_DIM);
+  }
+}
+
+// Kilobytes as megabytes, or "-" when unknown
+void PrintMegabytes(Frame& frame, int row, int column, long kilobytes,
+                    bool known = true) {
+  if (known) {
+    frame.Printf(row, column, A_NORMAL, "%ld", kilobytes / 1024);
+  } else {
+    frame.Print(row, column, "-", A_DIM);
+  }
+}
+}  // namespace
+
 void NCursesDisplay::DisplayProcesses(std::vector<Process>& processes,
-                                      WINDOW* window, int n) {
+                                      Frame& frame, int n,
+                                      System::SortOrder sort, bool tree) {
   int row{0};
   int const pid_column{2};
   int const user_column{9};
   int const cpu_column{16};
-  int const ram_column{26};
-  int const time_column{35};
-  int const command_column{46};
-  wattron(window, COLOR_PAIR(2));
-  mvwprintw(window, ++row, pid_column, "PID");
-  mvwprintw(window, row, user_column, "USER");
-  mvwprintw(window, row, cpu_column, "CPU[%%]");
-  mvwprintw(window, row, ram_column, "RAM[MB]");
-  mvwprintw(window, row, time_column, "TIME+");
-  mvwprintw(window, row, command_column, "COMMAND");
-  wattroff(window, COLOR_PAIR(2));
+  int const rss_column{24};
+  // PSS, USS and SWAP (24 columns) and READ/s and WRIT/s (14) are only
+  // shown where COMMAND keeps kMinCommandWidth columns after them, or
+  // while the list is sorted by memory or I/O. I/O goes first.
+  int const kMinCommandWidth{20};
+  int const detail_width{24};
+  int const io_width{14};
+  bool show_detail = sort == System::SortOrder::kMemory;
+  bool show_io = sort == System::SortOrder::kIo;
+  auto command_at = [&] {
+    return 43 + (show_detail ? detail_width : 0) + (show_io ? io_width : 0);
+  };
+  int const width = frame.Columns() - 1;
+  if (!show_io && command_at() + io_width + kMinCommandWidth <= width) {
+    show_io = true;
+  }
+  if (!show_detail &&
+      command_at() + detail_width + kMinCommandWidth <= width) {
+    show_detail = true;
+  }
+  int const pss_column{32};
+  int const uss_column{pss_column + 8};
+  int const swap_column{pss_column + 16};
+  int const read_column{pss_column + (show_detail ? detail_width : 0)};
+  int const write_column{read_column + 7};
+  int const time_column{read_column + (show_io ? io_width : 0)};
+  int const command_column{time_column + 11};
+  chtype const header = COLOR_PAIR(2);
+  chtype const cpu_header =
+      header | (sort == System::SortOrder::kCpu ? A_UNDERLINE : 0);
+  chtype const rss_header =
+      header | (sort == System::SortOrder::kMemory ? A_UNDERLINE : 0);
+  chtype const io_header =
+      header | (sort == System::SortOrder::kIo ? A_UNDERLINE : 0);
+  frame.Print(++row, pid_column, "PID", header);
+  frame.Print(row, user_column, "USER", header);
+  frame.Print(row, cpu_column, "CPU[%]", cpu_header);
+  frame.Print(row, rss_column, "RSS[MB]", rss_header);
+  if (show_detail) {
+    frame.Print(row, pss_column, "PSS", header);
+    frame.Print(row, uss_column, "USS", header);
+    frame.Print(row, swap_column, "SWAP", header);
+  }
+  if (show_io) {
+    frame.Print(row, read_column, "READ/s", io_header);
+    frame.Print(row, write_column, "WRIT/s", io_header);
+  }
+  frame.Print(row, time_column, "TIME+", header);
+  frame.Print(row, command_column,
+              tree ? "COMMAND (CPU and RSS per subtree)" : "COMMAND", header);
   int const num_processes = int(processes.size()) > n ? n : processes.size();
-  for (int i = 0; i < num_processes; ++i) {
-    mvwprintw(window, ++row, pid_column, to_string(processes[i].Pid()).c_str());
-    mvwprintw(window, row, user_column, processes[i].User().c_str());
-    float cpu = processes[i].CpuUtilization() * 100;
-    mvwprintw(window, row, cpu_column, to_string(cpu).substr(0, 4).c_str());
-    mvwprintw(window, row, ram_column, processes[i].Ram().c_str());
-    mvwprintw(window, row, time_column,
-              Format::ElapsedTime(processes[i].UpTime()).c_str());
-    mvwprintw(window, row, command_column,
-              processes[i].Command().substr(0, window->_maxx - 46).c_str());
+  // Thread sub-rows take the place of processes further down the list
+  int const last_row = frame.Rows() - 2;
+  char time[32];
+  for (int i = 0; i < num_processes && row < last_row; ++i) {
+    Process& process = processes[i];
+    frame.Printf(++row, pid_column, A_NORMAL, "%d", process.Pid());
+    frame.Printf(row, user_column, A_NORMAL, "%.6s", process.User().c_str());
+    const Process::Tree& position = process.TreePosition();
+    frame.Printf(row, cpu_column, A_NORMAL, "%.2f",
+                 (tree ? position.cpu : process.CpuUtilization()) * 100);
+    PrintMegabytes(frame, row, rss_column,
+                   tree ? position.rss_kb : process.RssKilobytes());
+    if (show_detail) {
+      const LinuxParser::SmapsRollupSnapshot& detail = process.MemoryDetail();
+      bool known = process.HasMemoryDetail();
+      PrintMegabytes(frame, row, pss_column, detail.pss_kb, known);
+      PrintMegabytes(frame, row, uss_column, detail.uss_kb, known);
+      PrintMegabytes(frame, row, swap_column, detail.swap_kb, known);
+    }
+    if (show_io) {
+      PrintRate(frame, row, read_column, process.ReadRate(), process.HasIo());
+      PrintRate(frame, row, write_column, process.WriteRate(),
+                process.HasIo());
+    }
+    Format::ElapsedTime(process.UpTime(), time, sizeof(time));
+    frame.Print(row, time_column, time);
+    if (tree) {
+      // "+" marks a collapsed subtree, "-" an expanded one
+      int column = command_column + 2 * position.depth;
+      char marker = position.descendants == 0 ? ' '
+                    : position.collapsed      ? '+'
+                                              : '-';
+      frame.Printf(row, column, A_NORMAL, "%c %s", marker,
+                   process.Command().c_str());
+      if (position.collapsed) {
+        int length = int(process.Command().size());
+        frame.Printf(row, column + 3 + length, A_DIM, "(%d)",
+                     position.descendants);
+      }
+    } else {
+      frame.Print(row, command_column, process.Command().c_str());
+    }
+    for (const Process::Thread& thread : process.Threads()) {
+      if (row >= last_row) break;
+      frame.Put(++row, pid_column, ACS_LLCORNER | A_DIM);
+      frame.Printf(row, pid_column + 1, A_DIM, "%d", thread.tid);
+      frame.Printf(row, cpu_column, A_DIM, "%.2f", thread.cpu * 100);
+      frame.Printf(row, command_column, A_DIM, "[%c] %s", thread.state,
+                   thread.name);
+    }
   }
 }
 
-void NCursesDisplay::Display(System& system, int n) {
-  initscr();      // start ncurses
-  noecho();       // do not print input values
-  cbreak();       // terminate ncurses on ctrl + c
-  start_color();  // enable color
+// One row per cgroup, in place of the process list
+void NCursesDisplay::DisplayCgroups(const std::vector<CgroupUsage>& cgroups,
+                                    Frame& frame, int n,
+                                    System::SortOrder sort) {
+  int row{0};
+  int const procs_column{2};
+  int const cpu_column{9};
+  int const memory_column{17};
+  int const read_column{26};
+  int const write_column{33};
+  int const cgroup_column{41};
+  chtype const header = COLOR_PAIR(2);
+  auto sorted = [&](System::SortOrder order) {
+    return header | (sort == order ? A_UNDERLINE : 0);
+  };
+  frame.Print(++row, procs_column, "PROCS", header);
+  frame.Print(row, cpu_column, "CPU[%]", sorted(System::SortOrder::kCpu));
+  frame.Print(row, memory_column, "MEM[MB]",
+              sorted(System::SortOrder::kMemory));
+  frame.Print(row, read_column, "READ/s", sorted(System::SortOrder::kIo));
+  frame.Print(row, write_column, "WRIT/s", sorted(System::SortOrder::kIo));
+  frame.Print(row, cgroup_column, "CGROUP", header);
+  int const count = std::min<int>(n, cgroups.size());
+  for (int i = 0; i < count; ++i) {
+    const CgroupUsage& group = cgroups[i];
+    frame.Printf(++row, procs_column, A_NORMAL, "%d", group.processes);
+    frame.Printf(row, cpu_column, A_NORMAL, "%.2f", group.cpu * 100);
+    frame.Printf(row, memory_column, A_NORMAL, "%llu",
+                 group.memory_kb / 1024);
+    PrintRate(frame, row, read_column, group.read_bps, group.has_io);
+    PrintRate(frame, row, write_column, group.write_bps, group.has_io);
+    frame.Print(row, cgroup_column, group.path.c_str());
+  }
+}
 
-  int x_max{getmaxx(stdscr)};
-  WINDOW* system_window = newwin(9, x_max - 1, 0, 0);
-  WINDOW* process_window =
-      newwin(3 + n, x_max - 1, system_window->_maxy + 1, 0);
+namespace {
+// The two windows and their frames, for the lifetime of an ncurses session
+class Screen {
+ public:
+  Screen(std::size_t cores, int n) : n_(n) {
+    initscr();      // start ncurses
+    noecho();       // do not print input values
+    cbreak();       // terminate ncurses on ctrl + c
+    start_color();  // enable color
+    curs_set(0);
+    keypad(stdscr, TRUE);
+    timeout(100);   // getch() waits at most 100 ms for a key
 
-  while (1) {
     init_pair(1, COLOR_BLUE, COLOR_BLACK);
     init_pair(2, COLOR_GREEN, COLOR_BLACK);
-    box(system_window, 0, 0);
-    box(process_window, 0, 0);
-    DisplaySystem(system, system_window);
-    DisplayProcesses(system.Processes(), process_window, n);
-    wrefresh(system_window);
-    wrefresh(process_window);
+    init_pair(3, COLOR_GREEN, COLOR_BLACK);
+    init_pair(4, COLOR_YELLOW, COLOR_BLACK);
+    init_pair(5, COLOR_RED, COLOR_BLACK);
+
+    int x_max{getmaxx(stdscr)};
+    // Thirteen fixed rows, the CPU breakdown, the core strip, the self cost
+    // line if compiled in and the border
+    int system_rows = 16 + (Instrument::kCompiled ? 1 : 0) +
+                      NCursesDisplay::HeatStripRows(cores, x_max - 1);
+    system_window_ = newwin(system_rows, x_max - 1, 0, 0);
+    process_window_ = newwin(3 + n, x_max - 1, system_rows, 0);
     refresh();
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+    system_frame_ = std::make_unique<Frame>(system_window_);
+    process_frame_ = std::make_unique<Frame>(process_window_);
+  }
+
+  ~Screen() {
+    system_frame_.reset();
+    process_frame_.reset();
+    delwin(system_window_);
+    delwin(process_window_);
+    endwin();
+  }
+
+  // Draw a snapshot; `status`, if given, replaces the latency line
+  void Draw(Snapshot& snapshot, const char* status = nullptr) {
+    system_frame_->Clear();
+    process_frame_->Clear();
+    NCursesDisplay::DisplaySystem(snapshot, *system_frame_);
+    if (status != nullptr) {
+      int row = system_frame_->Rows() - 2;
+      system_frame_->ClearRow(row);
+      system_frame_->Print(row, 2, status, A_BOLD);
+    }
+    if (snapshot.group_view) {
+      NCursesDisplay::DisplayCgroups(snapshot.cgroups, *process_frame_, n_,
+                                     snapshot.sort);
+    } else {
+      NCursesDisplay::DisplayProcesses(snapshot.processes, *process_frame_,
+                                       n_, snapshot.sort, snapshot.tree_view);
+    }
+    system_frame_->Flush();
+    process_frame_->Flush();
+    doupdate();
+  }
+
+ private:
+  int n_;
+  WINDOW* system_window_;
+  WINDOW* process_window_;
+  std::unique_ptr<Frame> system_frame_;
+  std::unique_ptr<Frame> process_frame_;
+};
+}  // namespace
+
+void NCursesDisplay::Display(System& system, int n,
+                             std::chrono::milliseconds interval,
+                             History* history, PressureTrigger* trigger) {
+  Screen screen(system.Cpu().Cores(), n);
+  Collector collector(system, n, interval);
+  collector.Record(history);
+  collector.WatchPressure(trigger);
+  collector.Start();
+  for (int key = getch(); key != 'q'; key = getch()) {
+    if (key == 's') {
+      Instrument::SetEnabled(!Instrument::Enabled());
+    } else if (key == 't') {
+      system.ThreadView(!system.ThreadView());
+    } else if (key == 'T') {
+      system.TreeView(!system.TreeView());
+    } else if (key == '+') {
+      system.TreeDepth(system.TreeDepth() + 1);
+    } else if (key == '-') {
+      system.TreeDepth(system.TreeDepth() - 1);
+    } else if (key == 'g') {
+      system.GroupView(!system.GroupView());
+    } else if (key == 'c') {
+      system.Sort(System::SortOrder::kCpu);
+    } else if (key == 'm') {
+      system.Sort(System::SortOrder::kMemory);
+    } else if (key == 'i') {
+      system.Sort(System::SortOrder::kIo);
+    } else if (key == '>') {
+      collector.Interval(collector.Interval() / 2);  // refresh faster
+    } else if (key == '<') {
+      collector.Interval(collector.Interval() * 2);
+    }
+    if (!collector.Update()) {
+      continue;
+    }
+    auto start = std::chrono::steady_clock::now();
+    INSTRUMENT_STAGE(kRender);
+    screen.Draw(collector.Latest());
+    collector.ReportRender(std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - start)
+                               .count());
+  }
+  collector.Stop();
+}
+
+// Play recorded ticks back at their recorded pace, times `speed`.
+// Keys: space pause, left/right step, [ ] jump a minute, f faster,
+// g/G first/last record, q quit.
+void NCursesDisplay::Replay(History& history, int n) {
+  using Clock = std::chrono::steady_clock;
+  Screen screen(0, n);
+  Snapshot snapshot;
+  std::size_t position = 0;
+  int speed = 1;
+  bool paused = false;
+  bool dirty = true;
+  auto next = Clock::now();
+  // The record after `position` is shown once its recorded interval has
+  // passed, divided by the speed
+  auto schedule = [&](Clock::time_point now, std::size_t last) {
+    std::uint32_t interval =
+        position < last ? history.At(position + 1).interval_ms : 0;
+    next = now + std::chrono::milliseconds(
+                     (interval > 0 ? interval : 1000) / speed);
+  };
+  timeout(50);
+  for (int key = getch(); key != 'q'; key = getch()) {
+    std::size_t size = history.Size();
+    if (size == 0) {
+      continue;
+    }
+    std::size_t last = size - 1;
+    switch (key) {
+      case ' ':
+        paused = !paused;
+        break;
+      case KEY_RIGHT:
+        paused = true;
+        position = std::min(position + 1, last);
+        break;
+      case KEY_LEFT:
+        paused = true;
+        position = position > 0 ? position - 1 : 0;
+        break;
+      case ']':
+        position = std::min<std::size_t>(position + 60, last);
+        break;
+      case '[':
+        position = position > 60 ? position - 60 : 0;
+        break;
+      case 'f':
+        speed = speed >= 16 ? 1 : speed * 2;
+        break;
+      case 'g':
+        position = 0;
+        break;
+      case 'G':
+        position = last;
+        break;
+      default:
+        break;
+    }
+    auto now = Clock::now();
+    if (key != ERR) {
+      // Show the record the key chose for a full interval
+      dirty = true;
+      schedule(now, last);
+    } else if (!paused && now >= next && position < last) {
+      ++position;
+      schedule(now, last);
+      dirty = true;
+    }
+    if (!dirty) {
+      continue;
+    }
+    history.Load(position, snapshot);
+    time_t seconds = snapshot.timestamp_ms / 1000;
+    char when[32];
+    strftime(when, sizeof(when), "%F %T", localtime(&seconds));
+    char status[128];
+    snprintf(status, sizeof(status), "Replay %s  [%zu/%zu]  x%d%s", when,
+             position + 1, size, speed, paused ? "  paused" : "");
+    screen.Draw(snapshot, status);
+    dirty = false;
   }
-  endwin();
 }
@@ -0,0 +1,88 @@
+#include "pressure_trigger.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "instrument.h"
+#include "linux_parser.h"
+
+using std::chrono::microseconds;
+
+PressureTrigger::~PressureTrigger() {
+  for (const pollfd& fd : fds_) {
+    if (fd.fd >= 0) close(fd.fd);
+  }
+}
+
+bool PressureTrigger::Arm(microseconds stall, microseconds window) {
+  constexpr microseconds kUnprivilegedWindow = std::chrono::seconds(2);
+  for (const char* resource : {"cpu", "memory", "io"}) {
+    if (ArmOne(resource, stall, window)) {
+      window_ = std::max(window_, window);
+    } else if (errno == EPERM &&
+               window % kUnprivilegedWindow != microseconds(0)) {
+      // Keep the stall share and round the window up
+      microseconds rounded =
+          (window / kUnprivilegedWindow + 1) * kUnprivilegedWindow;
+      if (ArmOne(resource, stall * rounded.count() / window.count(),
+                 rounded)) {
+        window_ = std::max(window_, rounded);
+      }
+    }
+  }
+  return Armed();
+}
+
+bool PressureTrigger::ArmOne(const char* resource, microseconds stall,
+                             microseconds window) {
+  std::string path = LinuxParser::kProcDirectory +
+                     LinuxParser::kPressureDirectory + "/" + resource;
+  int fd = open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  char trigger[64];
+  int length =
+      std::snprintf(trigger, sizeof(trigger), "some %lld %lld",
+                    static_cast<long long>(stall.count()),
+                    static_cast<long long>(window.count()));
+  // The terminating NUL is part of the trigger
+  if (write(fd, trigger, length + 1) < 0) {
+    int error = errno;
+    close(fd);
+    errno = error;
+    return false;
+  }
+  fds_.push_back({fd, POLLPRI, 0});
+  return true;
+}
+
+bool PressureTrigger::Armed() const { return !fds_.empty(); }
+
+microseconds PressureTrigger::Window() const { return window_; }
+
+bool PressureTrigger::Wait(std::chrono::milliseconds timeout) {
+  int ready = poll(fds_.data(), fds_.size(), int(timeout.count()));
+  INSTRUMENT_SYSCALLS(1);
+  if (ready <= 0) {
+    return false;
+  }
+  for (const pollfd& fd : fds_) {
+    if (fd.revents & POLLPRI) return true;
+  }
+  // POLLERR: the trigger is gone; poll() skips negative descriptors, so
+  // it is dropped rather than reported on every call
+  for (pollfd& fd : fds_) {
+    if (fd.fd >= 0 && (fd.revents & (POLLERR | POLLNVAL))) {
+      close(fd.fd);
+      fd.fd = -1;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,137 @@
+#include "proc_connector.h"
+
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "instrument.h"
+
+ProcConnector::~ProcConnector() {
+  stop_ = true;
+  if (listener_.joinable()) {
+    listener_.join();
+  }
+  if (socket_ >= 0) {
+    close(socket_);
+  }
+}
+
+bool ProcConnector::Start() {
+  socket_ = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+  if (socket_ < 0) {
+    return false;
+  }
+  sockaddr_nl address{};
+  address.nl_family = AF_NETLINK;
+  address.nl_groups = CN_IDX_PROC;
+  address.nl_pid = 0;  // assigned by the kernel
+  // Netlink header, connector header and operation back to back
+  alignas(nlmsghdr) char subscription[NLMSG_SPACE(
+      sizeof(cn_msg) + sizeof(proc_cn_mcast_op))] = {};
+  auto* header = reinterpret_cast<nlmsghdr*>(subscription);
+  header->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_cn_mcast_op));
+  header->nlmsg_type = NLMSG_DONE;
+  auto* message = static_cast<cn_msg*>(NLMSG_DATA(header));
+  message->id.idx = CN_IDX_PROC;
+  message->id.val = CN_VAL_PROC;
+  message->len = sizeof(proc_cn_mcast_op);
+  proc_cn_mcast_op operation = PROC_CN_MCAST_LISTEN;
+  std::memcpy(message->data, &operation, sizeof(operation));
+  if (bind(socket_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) !=
+          0 ||
+      send(socket_, subscription, header->nlmsg_len, 0) < 0) {
+    close(socket_);
+    socket_ = -1;
+    return false;
+  }
+  running_ = true;
+  listener_ = std::thread(&ProcConnector::Listen, this);
+  return true;
+}
+
+bool ProcConnector::Running() const { return running_; }
+
+bool ProcConnector::Drain(std::vector<Event>& events) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events.insert(events.end(), pending_.begin(), pending_.end());
+  pending_.clear();
+  bool complete = !lost_ && running_;
+  lost_ = false;
+  return complete;
+}
+
+// Poll with a timeout so the destructor does not wait on a quiet socket
+// for longer than a fraction of a second
+void ProcConnector::Listen() {
+  alignas(nlmsghdr) char buffer[8192];
+  pollfd descriptor{socket_, POLLIN, 0};
+  while (!stop_) {
+    int ready = poll(&descriptor, 1, 200);
+    INSTRUMENT_SYSCALLS(1);
+    if (ready <= 0) {
+      if (ready < 0 && errno != EINTR) break;
+      continue;
+    }
+    long size = recv(socket_, buffer, sizeof(buffer), 0);
+    INSTRUMENT_SYSCALLS(1);
+    if (size < 0) {
+      if (errno == EINTR || errno == EAGAIN) continue;
+      // ENOBUFS: the kernel dropped events because we fell behind
+      std::lock_guard<std::mutex> lock(mutex_);
+      lost_ = true;
+      if (errno != ENOBUFS) break;
+      continue;
+    }
+    Handle(buffer, size);
+  }
+  running_ = false;
+}
+
+void ProcConnector::Handle(const char* buffer, long size) {
+  std::vector<Event> events;
+  auto* header = reinterpret_cast<const nlmsghdr*>(buffer);
+  for (int length = size; NLMSG_OK(header, length);
+       header = NLMSG_NEXT(header, length)) {
+    if (header->nlmsg_type == NLMSG_ERROR ||
+        header->nlmsg_type == NLMSG_NOOP) {
+      continue;
+    }
+    auto* message = static_cast<const cn_msg*>(NLMSG_DATA(header));
+    auto* event = reinterpret_cast<const proc_event*>(message->data);
+    // Only thread group leaders are processes; thread events are ignored
+    switch (event->what) {
+      case proc_event::PROC_EVENT_FORK:
+        if (event->event_data.fork.child_pid ==
+            event->event_data.fork.child_tgid) {
+          events.push_back(
+              {Event::kFork, event->event_data.fork.child_tgid, false, {}});
+        }
+        break;
+      case proc_event::PROC_EVENT_EXEC:
+        events.push_back(
+            {Event::kExec, event->event_data.exec.process_tgid, false, {}});
+        break;
+      case proc_event::PROC_EVENT_EXIT:
+        if (event->event_data.exit.process_pid ==
+            event->event_data.exit.process_tgid) {
+          Event exit{Event::kExit, event->event_data.exit.process_tgid, false,
+                     {}};
+          exit.has_stat = LinuxParser::ReadProcStat(exit.pid, exit.stat);
+          events.push_back(exit);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  if (!events.empty()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.insert(pending_.end(), events.begin(), events.end());
+  }
+}
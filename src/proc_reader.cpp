@@ -0,0 +1,187 @@
+#include "proc_reader.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "instrument.h"
+#include "linux_parser.h"
+
+namespace {
+// Opened once and kept for the lifetime of the program
+int ProcDirectory() {
+  static const int fd = open(LinuxParser::kProcDirectory.c_str(),
+                             O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  return fd;
+}
+
+// Read a whole file into the calling thread's buffer. The buffer only
+// grows, so after the first few refreshes no read allocates.
+bool ReadAll(int directory, const char* path, std::string_view& contents) {
+  thread_local std::vector<char> buffer(4096);
+  int fd = openat(directory, path, O_RDONLY | O_CLOEXEC);
+  INSTRUMENT_SYSCALLS(1);
+  if (fd < 0) {
+    return false;
+  }
+  std::size_t size = 0;
+  while (true) {
+    if (size == buffer.size()) {
+      buffer.resize(buffer.size() * 2);
+    }
+    ssize_t count = read(fd, buffer.data() + size, buffer.size() - size);
+    INSTRUMENT_SYSCALLS(1);
+    if (count < 0) {
+      close(fd);
+      INSTRUMENT_SYSCALLS(1);
+      return false;
+    }
+    if (count == 0) {
+      break;
+    }
+    size += count;
+  }
+  close(fd);
+  INSTRUMENT_SYSCALLS(1);
+  INSTRUMENT_READ(size);
+  contents = std::string_view(buffer.data(), size);
+  return true;
+}
+
+// Paths relative to the /proc descriptor must not start with '/'
+const char* Relative(const std::string& name) {
+  const char* path = name.c_str();
+  while (*path == '/') ++path;
+  return path;
+}
+}  // namespace
+
+bool ProcReader::Read(const std::string& name, std::string_view& contents) {
+  return ReadAll(ProcDirectory(), Relative(name), contents);
+}
+
+namespace {
+
+// Append "<id>/" to `end`, which has room for at least 17 characters
+char* AppendId(char* end, int id) {
+  end = std::to_chars(end, end + 16, id).ptr;
+  *end++ = '/';
+  return end;
+}
+
+// Append `name` and the terminating NUL, if it fits before `limit`
+bool AppendName(char* end, const char* limit, const std::string& name) {
+  const char* relative = Relative(name);
+  std::size_t length = std::strlen(relative);
+  if (end + length + 1 > limit) {
+    return false;
+  }
+  std::memcpy(end, relative, length + 1);
+  return true;
+}
+}  // namespace
+
+bool ProcReader::Read(int pid, const std::string& name,
+                      std::string_view& contents) {
+  // "<pid>/<name>" formatted without touching the heap
+  char path[64];
+  return AppendName(AppendId(path, pid), path + sizeof(path), name) &&
+         ReadAll(ProcDirectory(), path, contents);
+}
+
+bool ProcReader::Read(int pid, int tid, const std::string& name,
+                      std::string_view& contents) {
+  // "<pid>/task/<tid>/<name>"
+  char path[80];
+  char* end = AppendId(path, pid);
+  std::memcpy(end, "task/", 5);
+  end = AppendId(end + 5, tid);
+  return AppendName(end, path + sizeof(path), name) &&
+         ReadAll(ProcDirectory(), path, contents);
+}
+
+bool ProcReader::ReadIds(int fd, std::vector<int>& ids, std::size_t limit) {
+  struct linux_dirent64 {
+    std::uint64_t d_ino;
+    std::int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+  };
+  thread_local std::vector<char> buffer(32 * 1024);
+  while (ids.size() < limit) {
+    long size = syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+    INSTRUMENT_SYSCALLS(1);
+    if (size < 0) {
+      return false;
+    }
+    if (size == 0) {
+      break;
+    }
+    for (long offset = 0; offset < size && ids.size() < limit;) {
+      const auto* file =
+          reinterpret_cast<const linux_dirent64*>(buffer.data() + offset);
+      offset += file->d_reclen;
+      // Is this a directory?
+      if (file->d_type == DT_DIR) {
+        // Is every character of the name a digit?
+        const char* name = file->d_name;
+        const char* end = name + std::strlen(name);
+        int id = 0;
+        auto result = std::from_chars(name, end, id);
+        if (result.ec == std::errc() && result.ptr == end && name != end) {
+          ids.push_back(id);
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool ProcReader::ListIds(int pid, const std::string& name,
+                         std::vector<int>& ids, std::size_t limit) {
+  char path[64];
+  if (!AppendName(AppendId(path, pid), path + sizeof(path), name)) {
+    return false;
+  }
+  int fd = openat(ProcDirectory(), path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  INSTRUMENT_SYSCALLS(1);
+  if (fd < 0) {
+    return false;
+  }
+  bool ok = ReadIds(fd, ids, limit);
+  close(fd);
+  INSTRUMENT_SYSCALLS(1);
+  return ok;
+}
+
+bool ProcReader::ReadPath(const std::string& path,
+                          std::string_view& contents) {
+  return ReadAll(AT_FDCWD, path.c_str(), contents);
+}
+
+std::string_view ProcReader::FindValue(std::string_view contents,
+                                       std::string_view key) {
+  std::size_t line = 0;
+  while (line < contents.size()) {
+    std::size_t end = contents.find('\n', line);
+    if (end == std::string_view::npos) end = contents.size();
+    std::size_t after = line + key.size();
+    // "processes" must not match a "processes_total" line
+    bool boundary = after >= end || !(std::isalnum(contents[after]) ||
+                                      contents[after] == '_');
+    if (boundary && contents.compare(line, key.size(), key) == 0) {
+      return contents.substr(line + key.size(), end - line - key.size());
+    }
+    line = end + 1;
+  }
+  return {};
+}
@@ -13,48 +13,137 @@ using std::string;
 using std::to_string;
 using std::vector;
 
-Process::Process(int pid) : pid_(pid)
-{
-  command_ = LinuxParser::Command(pid_);
-  user_ = LinuxParser::User(pid_);
+// Command, user and cgroup are resolved once, when the process is first
+// seen
+Process::Process(int pid, const LinuxParser::ProcStatSnapshot& stat,
+                 PooledString user)
+    : pid_(pid), user_(std::move(user)), stat_(stat) {
+  command_ = PooledString(LinuxParser::Command(pid_));
+  cgroup_ = PooledString(LinuxParser::Cgroup(pid_));
+  active_jiffies_ = stat_.utime + stat_.stime;
+}
+
+Process::Process(int pid, std::string_view user, std::string_view command,
+                 float cpu, unsigned long ram_mb, long start_seconds,
+                 long system_uptime)
+    : pid_(pid),
+      user_(user),
+      command_(command),
+      system_uptime_(system_uptime),
+      cpu_(cpu) {
+  stat_.pid = pid;
+  stat_.rss = ram_mb * 1024 * 1024 / LinuxParser::PageSize();
+  stat_.starttime = start_seconds * LinuxParser::ClockTicks();
+}
+
+// CPU usage is the share of one core used since the previous sample, so a
+// long-lived idle process no longer outranks one that is busy right now
+void Process::Update(const LinuxParser::ProcStatSnapshot& stat,
+                     long system_uptime, float elapsed_seconds) {
+  unsigned long long active_jiffies = stat.utime + stat.stime;
+  cpu_ = 0.0f;
+  interval_jiffies_ = active_jiffies >= active_jiffies_
+                          ? active_jiffies - active_jiffies_
+                          : 0;
+  if (elapsed_seconds > 0.0f) {
+    cpu_ = interval_jiffies_ / (elapsed_seconds * LinuxParser::ClockTicks());
+  }
+  active_jiffies_ = active_jiffies;
+  system_uptime_ = system_uptime;
+  stat_ = stat;
+}
+
+// The PID and start time survive exec(), so the CPU baseline is kept
+void Process::Exec(Process&& image) {
+  command_ = std::move(image.command_);
+  user_ = std::move(image.user_);
+  cgroup_ = std::move(image.cgroup_);
+}
+
+unsigned long long Process::ActiveJiffies() const { return active_jiffies_; }
 
+unsigned long long Process::IntervalJiffies() const {
+  return interval_jiffies_;
 }
 
 // Return this process's ID
-int Process::Pid() { return pid_; }
+int Process::Pid() const { return pid_; }
+
+int Process::ParentPid() const { return stat_.ppid; }
 
 // Return this process's CPU utilization
-float Process::CpuUtilization() const{
-  float cpu {0.0f}; 
+float Process::CpuUtilization() const { return cpu_; }
+
+// Return the command that generated this process
+const PooledString& Process::Command() const { return command_; }
 
-  long int system_uptime = LinuxParser::UpTime();
-  long int active_jiffies = LinuxParser::ActiveJiffies(pid_);
-  long int process_uptime = LinuxParser::UpTime(pid_);
+const PooledString& Process::Cgroup() const { return cgroup_; }
 
-  if(system_uptime - process_uptime > 0)
-  {
-    cpu = active_jiffies / float(system_uptime - process_uptime);
-  }
+// Return this process's memory utilization
+string Process::Ram() { return to_string(RamMegabytes()); }
+
+unsigned long Process::RamMegabytes() const { return RssKilobytes() / 1024; }
 
-  return cpu;
-  
+// Resident set size, from the rss field of stat (in pages)
+unsigned long Process::RssKilobytes() const {
+  return stat_.rss > 0 ? stat_.rss * (LinuxParser::PageSize() / 1024) : 0;
 }
 
-// Return the command that generated this process
-string Process::Command() { return command_; }
+bool Process::HasMemoryDetail() const { return has_memory_detail_; }
 
-// Return this process's memory utilization
-string Process::Ram() { return LinuxParser::Ram(pid_); }
+const LinuxParser::SmapsRollupSnapshot& Process::MemoryDetail() const {
+  return memory_detail_;
+}
+
+void Process::SetMemoryDetail(
+    const LinuxParser::SmapsRollupSnapshot& detail) {
+  memory_detail_ = detail;
+  has_memory_detail_ = true;
+}
+
+// The first sample only sets the baseline
+void Process::UpdateIo(const LinuxParser::ProcIoSnapshot& io,
+                       float elapsed_seconds) {
+  read_rate_ = write_rate_ = 0.0f;
+  if (has_io_ && elapsed_seconds > 0.0f) {
+    if (io.read_bytes >= io_.read_bytes) {
+      read_rate_ = (io.read_bytes - io_.read_bytes) / elapsed_seconds;
+    }
+    if (io.write_bytes >= io_.write_bytes) {
+      write_rate_ = (io.write_bytes - io_.write_bytes) / elapsed_seconds;
+    }
+  }
+  io_ = io;
+  has_io_ = true;
+}
+
+bool Process::HasIo() const { return has_io_; }
+
+float Process::ReadRate() const { return read_rate_; }
+
+float Process::WriteRate() const { return write_rate_; }
 
 // Return the user (name) that generated this process
-string Process::User() { return user_; }
+const PooledString& Process::User() const { return user_; }
 
 // Return the age of this process (in seconds)
-long int Process::UpTime() { 
-  return LinuxParser::UpTime() - LinuxParser::UpTime(pid_); 
+long int Process::UpTime() const {
+  return system_uptime_ - stat_.starttime / LinuxParser::ClockTicks();
+}
+
+unsigned long long Process::StartTime() const { return stat_.starttime; }
+
+long Process::ThreadCount() const { return stat_.num_threads; }
+
+const vector<Process::Thread>& Process::Threads() const { return threads_; }
+
+void Process::SetThreads(const vector<Thread>& threads) {
+  threads_ = threads;
 }
 
+const Process::Tree& Process::TreePosition() const { return tree_; }
+
+void Process::SetTreePosition(const Tree& tree) { tree_ = tree; }
+
 // Overload the "less than" comparison operator for Process objects
-bool Process::operator<(Process const& a) const {
-  return CpuUtilization() < a.CpuUtilization();
-}
\ No newline at end of file
+bool Process::operator<(Process const& a) const { return cpu_ < a.cpu_; }
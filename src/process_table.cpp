@@ -0,0 +1,116 @@
+#include "process_table.h"
+
+#include <algorithm>
+
+using std::size_t;
+using std::uint32_t;
+
+void ProcessTable::Clear() {
+  pid_.clear();
+  cpu_.clear();
+  rss_kb_.clear();
+  io_.clear();
+  user_.clear();
+  start_.clear();
+  command_.clear();
+}
+
+void ProcessTable::Append(const Process& process) {
+  pid_.push_back(process.Pid());
+  cpu_.push_back(process.CpuUtilization());
+  rss_kb_.push_back(process.RssKilobytes());
+  io_.push_back(process.ReadRate() + process.WriteRate());
+  user_.push_back(process.User().Id());
+  start_.push_back(process.StartTime());
+  command_.push_back(process.Command().Id());
+}
+
+size_t ProcessTable::Size() const { return pid_.size(); }
+
+int ProcessTable::Pid(size_t row) const { return pid_[row]; }
+
+unsigned long long ProcessTable::StartTime(size_t row) const {
+  return start_[row];
+}
+
+uint32_t ProcessTable::Command(size_t row) const { return command_[row]; }
+
+// The tests run over the whole columns with no branches, so they compile
+// to packed compares; only the compaction after them is scalar
+size_t ProcessTable::Select(const Filter& filter,
+                            std::vector<uint32_t>& order) {
+  size_t size = Size();
+  pass_.resize(size);
+  const float* cpu = cpu_.data();
+  const uint32_t* user = user_.data();
+  const uint32_t* command = command_.data();
+  std::uint8_t* pass = pass_.data();
+  float min_cpu = filter.min_cpu;
+  for (size_t row = 0; row < size; ++row) {
+    pass[row] = cpu[row] >= min_cpu;
+  }
+  // The handle columns are only scanned when they are filtered on
+  if (filter.user != 0) {
+    uint32_t wanted = filter.user;
+    for (size_t row = 0; row < size; ++row) {
+      pass[row] &= user[row] == wanted;
+    }
+  }
+  if (filter.command != 0) {
+    uint32_t wanted = filter.command;
+    for (size_t row = 0; row < size; ++row) {
+      pass[row] &= command[row] == wanted;
+    }
+  }
+  // Passing rows fill order from the front, the others from the back
+  order.resize(size);
+  size_t front = 0;
+  size_t back = size;
+  for (size_t row = 0; row < size; ++row) {
+    bool passed = pass[row];
+    back -= !passed;
+    order[passed ? front : back] = uint32_t(row);
+    front += passed;
+  }
+  return front;
+}
+
+// One gather per column, so the loop does not switch on every row
+template <typename T>
+void ProcessTable::Gather(const std::vector<T>& values,
+                          const std::vector<uint32_t>& order, size_t count) {
+  keys_.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    keys_[i] = {double(values[order[i]]), order[i]};
+  }
+}
+
+void ProcessTable::Rank(Column column, std::vector<uint32_t>& order,
+                        size_t count, size_t n) {
+  n = std::min(n, count);
+  switch (column) {
+    case Column::kRss:
+      Gather(rss_kb_, order, count);
+      break;
+    case Column::kIo:
+      Gather(io_, order, count);
+      break;
+    default:
+      Gather(cpu_, order, count);
+      break;
+  }
+  // Start time before PID, so ties keep their order when PIDs wrap
+  const unsigned long long* start = start_.data();
+  const int* pid = pid_.data();
+  std::partial_sort(keys_.begin(), keys_.begin() + n, keys_.end(),
+                    [start, pid](const Key& a, const Key& b) {
+                      if (a.value != b.value) return a.value > b.value;
+                      if (start[a.row] != start[b.row]) {
+                        return start[a.row] < start[b.row];
+                      }
+                      return pid[a.row] < pid[b.row];
+                    });
+  for (size_t i = 0; i < count; ++i) {
+    order[i] = keys_[i].row;
+  }
+}
@@ -1,17 +1,58 @@
 #include "processor.h"
 #include "linux_parser.h"
-// Return the aggregate CPU utilization
-float Processor::Utilization() {
-    
-    float activeJiff = LinuxParser::ActiveJiffies();
-    float iddleJiff = LinuxParser::IdleJiffies();
 
-    float util {0.0f};
+using LinuxParser::CPUStates;
 
-    if (activeJiff + iddleJiff > 0.0f)
-    {
-        return activeJiff / (activeJiff + iddleJiff);
+// Split the jiffies spent between two samples by state. The first sample
+// is measured against zero, i.e. since boot.
+CpuBreakdown Processor::Interval(const CpuTimes& previous,
+                                 const CpuTimes& current) {
+    auto delta = [&](int state) -> float {
+        return current[state] > previous[state]
+                   ? float(current[state] - previous[state])
+                   : 0.0f;
+    };
+    CpuBreakdown breakdown;
+    breakdown.user = delta(CPUStates::kUser_) + delta(CPUStates::kNice_);
+    breakdown.system = delta(CPUStates::kSystem_);
+    breakdown.irq = delta(CPUStates::kIRQ_) + delta(CPUStates::kSoftIRQ_);
+    breakdown.steal = delta(CPUStates::kSteal_);
+    breakdown.iowait = delta(CPUStates::kIOwait_);
+    breakdown.idle = delta(CPUStates::kIdle_);
+
+    float total = breakdown.Busy() + breakdown.iowait + breakdown.idle;
+    if (total > 0.0f) {
+        for (float* share : {&breakdown.user, &breakdown.system,
+                             &breakdown.irq, &breakdown.steal,
+                             &breakdown.iowait, &breakdown.idle}) {
+            *share /= total;
+        }
+    }
+    return breakdown;
+}
+
+// Compare the snapshot with the previous one, for the aggregate and for
+// every core
+void Processor::Update(const SystemSnapshot& snapshot) {
+    aggregate_ = Interval(previous_, snapshot.cpu);
+    previous_ = snapshot.cpu;
+
+    std::size_t cores = snapshot.cores.size();
+    previous_cores_.resize(cores);
+    cores_.resize(cores);
+    for (std::size_t i = 0; i < cores; ++i) {
+        cores_[i] = Interval(previous_cores_[i], snapshot.cores[i]).Busy();
+        previous_cores_[i] = snapshot.cores[i];
     }
+}
+
+// Return the aggregate CPU utilization over the last interval
+float Processor::Utilization() { return aggregate_.Busy(); }
+
+const CpuBreakdown& Processor::Breakdown() const { return aggregate_; }
+
+std::size_t Processor::Cores() const { return cores_.size(); }
 
-    return util;
-}
\ No newline at end of file
+float Processor::CoreUtilization(std::size_t core) const {
+    return core < cores_.size() ? cores_[core] : 0.0f;
+}
@@ -0,0 +1,37 @@
+#include "scheduler.h"
+
+#include <algorithm>
+
+namespace {
+const Scheduler::Policy kPolicies[Scheduler::kSources] = {
+    // Cheap and read for the rows on screen every refresh; their rates
+    // then move with the display. The others only feed the tree and
+    // cgroup rollups, which tolerate a few seconds of lag. (Sorting by I/O
+    // reads every process every refresh instead; see System::Scan.)
+    {"io", 3, 1, 10},
+    // Three syscalls too, but the kernel walks every mapping of the
+    // process to produce it, so it is by far the most expensive file
+    {"smaps_rollup", 30, 2, 60},
+};
+}  // namespace
+
+const Scheduler::Policy& Scheduler::Of(Source source) {
+  return kPolicies[source];
+}
+
+unsigned long Scheduler::Period(Source source, std::size_t population) {
+  const Policy& policy = kPolicies[source];
+  unsigned long affordable =
+      (population * policy.cost + kBackgroundBudget - 1) / kBackgroundBudget;
+  return std::max({affordable, policy.hidden, 1UL});
+}
+
+bool Scheduler::Due(Source source, unsigned long tick, unsigned long sampled,
+                    bool listed, int pid, std::size_t population) {
+  if (listed) {
+    return sampled == 0 || tick - sampled >= kPolicies[source].listed;
+  }
+  return (static_cast<unsigned long>(pid) + tick) %
+             Period(source, population) ==
+         0;
+}
@@ -0,0 +1,185 @@
+#include "string_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+using std::uint32_t;
+
+namespace {
+// The smallest class whose blocks hold `length` bytes and the NUL
+unsigned SizeClass(std::size_t length, unsigned min_class) {
+  unsigned size_class = min_class;
+  while ((std::size_t(1) << size_class) < length + 1) {
+    ++size_class;
+  }
+  return size_class;
+}
+}  // namespace
+
+// Never destroyed: handles in static objects may be released after static
+// destructors run
+StringPool& StringPool::Shared() {
+  static auto* pool = new StringPool;
+  return *pool;
+}
+
+StringPool::Entry& StringPool::At(uint32_t id) const {
+  return segments_[id >> kSegmentBits][id & (kSegmentSize - 1)];
+}
+
+uint32_t StringPool::Intern(std::string_view text) {
+  text = text.substr(0, kMaxLength);
+  if (text.empty()) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(text);
+  if (it != index_.end()) {
+    At(it->second).references.fetch_add(1, std::memory_order_relaxed);
+    return it->second;
+  }
+  uint32_t id = NewEntry();
+  if (id == 0) {
+    return 0;  // table full; shown as empty
+  }
+  Entry& entry = At(id);
+  entry.data = Allocate(SizeClass(text.size(), kMinClass));
+  std::memcpy(entry.data, text.data(), text.size());
+  entry.data[text.size()] = '\0';
+  entry.length = text.size();
+  entry.references.store(1, std::memory_order_relaxed);
+  index_.emplace(std::string_view(entry.data, entry.length), id);
+  return id;
+}
+
+void StringPool::Acquire(uint32_t id) {
+  if (id != 0) {
+    At(id).references.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void StringPool::Release(uint32_t id) {
+  if (id == 0) {
+    return;
+  }
+  Entry& entry = At(id);
+  if (entry.references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Intern() may have handed the string out again before the lock was
+  // taken, and its new holders may even have freed it already
+  if (entry.references.load(std::memory_order_relaxed) == 0 &&
+      entry.data != nullptr) {
+    Free(id);
+  }
+}
+
+std::string_view StringPool::View(uint32_t id) const {
+  if (id == 0) {
+    return {};
+  }
+  const Entry& entry = At(id);
+  return std::string_view(entry.data, entry.length);
+}
+
+// Index nodes are estimated at the key, the value and two pointers
+StringPool::Usage StringPool::Stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Usage usage;
+  usage.strings = index_.size();
+  usage.bytes = chunks_.size() * kChunkSize +
+                (entries_ + kSegmentSize - 1) / kSegmentSize * kSegmentSize *
+                    sizeof(Entry) +
+                index_.size() * (sizeof(std::string_view) + 3 * sizeof(void*)) +
+                index_.bucket_count() * sizeof(void*);
+  return usage;
+}
+
+uint32_t StringPool::NewEntry() {
+  if (!free_entries_.empty()) {
+    uint32_t id = free_entries_.back();
+    free_entries_.pop_back();
+    return id;
+  }
+  std::size_t segment = entries_ >> kSegmentBits;
+  if (segment >= kSegments) {
+    return 0;
+  }
+  if (!segments_[segment]) {
+    segments_[segment] = std::make_unique<Entry[]>(kSegmentSize);
+  }
+  return entries_++;
+}
+
+// Blocks come from the free list of their class, or else from the end of
+// the current chunk. The tail of a chunk too short for the block is split
+// into free blocks of smaller classes. Chunks are left uninitialized, so
+// pages not yet used take no memory.
+char* StringPool::Allocate(unsigned size_class) {
+  std::vector<char*>& blocks = free_blocks_[size_class];
+  if (!blocks.empty()) {
+    char* block = blocks.back();
+    blocks.pop_back();
+    return block;
+  }
+  std::size_t size = std::size_t(1) << size_class;
+  if (kChunkSize - chunk_used_ < size) {
+    if (!chunks_.empty()) {
+      for (unsigned tail = kMaxClass; tail >= kMinClass; --tail) {
+        std::size_t tail_size = std::size_t(1) << tail;
+        while (kChunkSize - chunk_used_ >= tail_size) {
+          free_blocks_[tail].push_back(chunks_.back().get() + chunk_used_);
+          chunk_used_ += tail_size;
+        }
+      }
+    }
+    chunks_.emplace_back(new char[kChunkSize]);
+    chunk_used_ = 0;
+  }
+  char* block = chunks_.back().get() + chunk_used_;
+  chunk_used_ += size;
+  return block;
+}
+
+void StringPool::Free(uint32_t id) {
+  Entry& entry = At(id);
+  index_.erase(std::string_view(entry.data, entry.length));
+  free_blocks_[SizeClass(entry.length, kMinClass)].push_back(entry.data);
+  entry.data = nullptr;
+  entry.length = 0;
+  free_entries_.push_back(id);
+}
+
+PooledString::PooledString(std::string_view text)
+    : id_(StringPool::Shared().Intern(text)) {}
+
+PooledString::PooledString(const PooledString& other) : id_(other.id_) {
+  StringPool::Shared().Acquire(id_);
+}
+
+PooledString::PooledString(PooledString&& other) noexcept : id_(other.id_) {
+  other.id_ = 0;
+}
+
+PooledString& PooledString::operator=(PooledString other) noexcept {
+  std::swap(id_, other.id_);
+  return *this;
+}
+
+PooledString::~PooledString() { StringPool::Shared().Release(id_); }
+
+std::string_view PooledString::View() const {
+  return StringPool::Shared().View(id_);
+}
+
+const char* PooledString::c_str() const {
+  return id_ != 0 ? StringPool::Shared().View(id_).data() : "";
+}
+
+std::size_t PooledString::size() const { return View().size(); }
+
+bool PooledString::empty() const { return id_ == 0; }
+
+uint32_t PooledString::Id() const { return id_; }
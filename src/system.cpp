@@ -2,57 +2,650 @@
 
 #include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "instrument.h"
 #include "process.h"
 #include "processor.h"
+#include "scheduler.h"
 
 using std::set;
 using std::size_t;
 using std::string;
 using std::vector;
 
+System::System(unsigned threads, bool proc_events)
+    : pool_(threads),
+      kernel_(LinuxParser::Kernel()),
+      operating_system_(LinuxParser::OperatingSystem()) {
+    if (proc_events) {
+        connector_.Start();  // falls back to scanning /proc on failure
+    }
+    Refresh();
+}
+
+// Every accessor below answers from this snapshot, so /proc/stat,
+// /proc/meminfo, /proc/uptime, /proc/diskstats, /proc/loadavg and
+// /proc/pressure are read once per frame
+void System::Refresh() {
+    sampler_.Refresh(snapshot_);
+    cpu_.Update(snapshot_);
+    disks_.Update(snapshot_);
+}
+
 // Return the system's CPU
 Processor& System::Cpu() { return cpu_; }
 
+const DiskStats& System::Disks() const { return disks_; }
+
+// Return the PIDs to sample in this refresh. Without the proc connector
+// that is a full listing of /proc; with it the list is kept up to date from
+// fork/exec/exit events and only reconciled against /proc now and then.
+vector<int> System::CollectPids() {
+    exec_pids_.clear();
+    events_.clear();
+    if (!connector_.Running()) {
+        return LinuxParser::Pids();
+    }
+
+    bool complete = connector_.Drain(events_);
+    for (const auto& event : events_) {
+        switch (event.type) {
+            case ProcConnector::Event::kFork:
+                live_pids_.insert(event.pid);
+                break;
+            case ProcConnector::Event::kExec:
+                live_pids_.insert(event.pid);
+                exec_pids_.insert(event.pid);
+                break;
+            case ProcConnector::Event::kExit:
+                live_pids_.erase(event.pid);
+                break;
+        }
+    }
+
+    if (!complete || reconciled_at_ == 0 ||
+        generation_ - reconciled_at_ >= kReconcileInterval) {
+        auto pids = LinuxParser::Pids();
+        live_pids_.clear();
+        live_pids_.insert(pids.begin(), pids.end());
+        reconciled_at_ = generation_;
+        return pids;
+    }
+    return vector<int>(live_pids_.begin(), live_pids_.end());
+}
+
 // Return a container composed of the system's processes
-vector<Process>& System::Processes() { 
-    processes_.clear();    
-    auto pids = LinuxParser::Pids();
+vector<Process>& System::Processes(int n) {
+    auto now = std::chrono::steady_clock::now();
+    {
+        INSTRUMENT_STAGE(kCollect);
+        Scan(now);
+    }
+    auto sort_start = std::chrono::steady_clock::now();
+    stage_times_.collect =
+        std::chrono::duration<double, std::milli>(sort_start - now).count();
+    {
+        INSTRUMENT_STAGE(kSort);
+        Rank(n);
+    }
+    auto sort_end = std::chrono::steady_clock::now();
+    stage_times_.sort =
+        std::chrono::duration<double, std::milli>(sort_end - sort_start)
+            .count();
+
+    // Reads that only concern some processes, now that the top n is known
+    {
+        INSTRUMENT_STAGE(kCollect);
+        if (memory_detail_) {
+            SampleMemory();
+        }
+        SampleIo();
+        processes_.clear();
+        if (tree_view_) {
+            BuildTree(n);
+        } else {
+            for (size_t i = 0; i < ranked_; ++i) {
+                processes_.push_back(tracked_[order_[i]]->process);
+            }
+        }
+        if (thread_view_) {
+            ExpandThreads();
+        } else if (!threads_.empty()) {
+            threads_.clear();
+        }
+        cgroups_.clear();
+        if (group_view_) {
+            RankCgroups(n);
+        }
+    }
+    stage_times_.collect += std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - sort_end)
+                                .count();
+    return processes_;
+}
+
+void System::MemoryDetail(bool enabled) { memory_detail_ = enabled; }
 
-    //ncurses display will only show 10 process
-    // So this can be limited
-    for(unsigned int i = 0; i < pids.size() && i < 10; ++i)
+bool System::MemoryDetail() const { return memory_detail_; }
+
+void System::ThreadView(bool enabled) { thread_view_ = enabled; }
+
+bool System::ThreadView() const { return thread_view_; }
+
+void System::GroupView(bool enabled) { group_view_ = enabled; }
+
+bool System::GroupView() const { return group_view_; }
+
+const vector<CgroupUsage>& System::Cgroups() const { return cgroups_; }
+
+// Roll the live processes up by cgroup and keep the n cgroups ranking
+// highest. A cgroup's CPU is the CPU time of all its tasks, including those
+// that exited during the interval.
+void System::RankCgroups(int n) {
+    for (const TrackedProcess* tracked : tracked_) {
+        cgroup_stats_.Add(tracked->process);
+    }
+    cgroup_stats_.Update(elapsed_);
+    vector<CgroupUsage>& usage = cgroup_stats_.Usage();
+    SortOrder order = sort_;
+    auto value = [order](const CgroupUsage& group) -> double {
+        switch (order) {
+            case SortOrder::kMemory:
+                return double(group.memory_kb);
+            case SortOrder::kIo:
+                return double(group.read_bps) + group.write_bps;
+            default:
+                return group.cpu;
+        }
+    };
+    size_t ranked = std::min<size_t>(std::max(n, 0), usage.size());
+    std::partial_sort(usage.begin(), usage.begin() + ranked, usage.end(),
+                      [&](const CgroupUsage& a, const CgroupUsage& b) {
+                          double va = value(a), vb = value(b);
+                          if (va != vb) return va > vb;
+                          return a.path < b.path;
+                      });
+    cgroups_.assign(usage.begin(), usage.begin() + ranked);
+}
+
+// Read the threads of the processes about to be returned and measure each
+// against its previous sample. A thread seen for the first time (including
+// every thread of a process that just entered the top n) shows no CPU
+// until the next refresh.
+void System::ExpandThreads() {
+    task_stats_.resize(processes_.size());
+    pool_.ParallelFor(processes_.size(), 1, [&](size_t begin, size_t end) {
+        INSTRUMENT_STAGE_CPU(kCollect);
+        for (size_t i = begin; i < end; ++i) {
+            auto& stats = task_stats_[i];
+            stats.clear();
+            int pid = processes_[i].Pid();
+            if (processes_[i].ThreadCount() <= 1) {
+                continue;
+            }
+            for (int tid : LinuxParser::Tids(pid, kMaxThreads)) {
+                stats.emplace_back();
+                if (!LinuxParser::ReadTaskStat(pid, tid, stats.back())) {
+                    stats.pop_back();  // exited since it was listed
+                }
+            }
+        }
+    });
+
+    float ticks = elapsed_ * LinuxParser::ClockTicks();
+    for (size_t i = 0; i < processes_.size(); ++i) {
+        thread_rows_.clear();
+        for (const auto& stat : task_stats_[i]) {
+            unsigned long long jiffies = stat.utime + stat.stime;
+            auto inserted =
+                threads_.try_emplace({stat.pid, stat.starttime},
+                                     TrackedThread{jiffies, generation_});
+            TrackedThread& tracked = inserted.first->second;
+            float cpu = 0.0f;
+            if (!inserted.second && ticks > 0.0f &&
+                jiffies >= tracked.jiffies) {
+                cpu = (jiffies - tracked.jiffies) / ticks;
+            }
+            tracked = {jiffies, generation_};
+            Process::Thread row{stat.pid, {}, stat.state, cpu};
+            std::copy(std::begin(stat.comm), std::end(stat.comm), row.name);
+            thread_rows_.push_back(row);
+        }
+        auto middle = thread_rows_.begin() +
+                      std::min(kThreadsShown, thread_rows_.size());
+        std::partial_sort(thread_rows_.begin(), middle, thread_rows_.end(),
+                          [](const Process::Thread& a,
+                             const Process::Thread& b) {
+                              if (a.cpu != b.cpu) return a.cpu > b.cpu;
+                              return a.tid < b.tid;
+                          });
+        thread_rows_.erase(middle, thread_rows_.end());
+        processes_[i].SetThreads(thread_rows_);
+    }
+
+    // Threads not read this time exited or belong to a process that left
+    // the top n
+    for (auto it = threads_.begin(); it != threads_.end();) {
+        if (it->second.generation != generation_) {
+            it = threads_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Sample every PID into the table, note the processes that exited and
+// collect the sort keys of the others
+void System::Scan(std::chrono::steady_clock::time_point now) {
+    float elapsed = 0.0f;
+    if (generation_ > 0) {
+        elapsed = std::chrono::duration<float>(now - last_refresh_).count();
+    }
+    elapsed_ = elapsed;
+    last_refresh_ = now;
+    ++generation_;
+
+    auto pids = CollectPids();
+    users_.Refresh();
+    long uptime = UpTime();
+    SortOrder order = sort_;
+
+    // Every PID is sampled: readdir order says nothing about CPU usage, so
+    // the busiest processes can be anywhere in the list.
+    // Workers only read the table; new processes (whose command and user
+    // have to be resolved) are built in the worker and inserted afterwards.
+    samples_.resize(pids.size());
+    pool_.ParallelFor(pids.size(), 64, [&](std::size_t begin, std::size_t end) {
+        INSTRUMENT_STAGE_CPU(kCollect);
+        for (std::size_t i = begin; i < end; ++i) {
+            Sample& sample = samples_[i];
+            sample.created.reset();
+            sample.valid = LinuxParser::ReadProcStat(pids[i], sample.stat);
+            sample.io_valid = sample.io_denied = false;
+            if (!sample.valid) {
+                continue;
+            }
+            auto it = table_.find({pids[i], sample.stat.starttime});
+            // Sorting by I/O reads io for every process, since any of them
+            // may be the busiest; otherwise SampleIo() reads it on its
+            // schedule. A process that denied it once is not asked again.
+            if (order == SortOrder::kIo &&
+                (it == table_.end() || !it->second.io_denied)) {
+                sample.io_valid = LinuxParser::ReadProcIo(pids[i], sample.io);
+                sample.io_denied =
+                    !sample.io_valid && (errno == EACCES || errno == EPERM);
+            }
+            // A process that called exec() needs its command and user
+            // resolved again
+            if (it == table_.end() || exec_pids_.count(pids[i]) > 0) {
+                LinuxParser::ProcStatusSnapshot status;
+                PooledString user;
+                if (LinuxParser::ReadProcStatus(pids[i], status) &&
+                    status.uid >= 0) {
+                    user = users_.Name(status.uid);
+                } else {
+                    user = PooledString("Unknown");
+                }
+                sample.created.emplace(pids[i], sample.stat, std::move(user));
+            }
+        }
+    });
+
+    for (std::size_t i = 0; i < pids.size(); ++i)
     {
-        Process proc(pids[i]);
-        //you do not need to call the constructor when inserting an element using emplace_back into the vector of some class 
-        //if the constructor of the class has an appropriate definition that can be called on that set of arguments!
-        //So this line can be replaced with: processes_.emplace_back(pid);
-        processes_.push_back(proc);
+        Sample& sample = samples_[i];
+        if (!sample.valid) {
+            continue;  // exited since Pids() listed it
+        }
+        ProcessKey key{pids[i], sample.stat.starttime};
+        auto it = table_.find(key);
+        if (it == table_.end()) {
+            it = table_.emplace(key, TrackedProcess{std::move(*sample.created), 0})
+                     .first;
+            // Replaces an earlier process with the same PID, if that one
+            // has not been swept yet
+            by_pid_[key.pid] = &it->second;
+        } else if (sample.created) {
+            it->second.process.Exec(std::move(*sample.created));
+        }
+        sample.created.reset();
+        it->second.process.Update(sample.stat, uptime, elapsed);
+        if (it->second.parent != sample.stat.ppid) {
+            Reparent(it->second, sample.stat.ppid);
+        }
+        if (sample.io_valid) {
+            UpdateIo(it->second, sample.io);
+        } else if (sample.io_denied) {
+            it->second.io_denied = true;
+        }
+        it->second.generation = generation_;
+    }
+
+    // Exit events usually carry the stat read as the process exited: that
+    // is the final sample of a known process, or the only trace of one that
+    // lived and died between two refreshes. Where the parent reaped it
+    // before the read, a known process is reported by the sweep below with
+    // its last sample, and one never sampled is missed.
+    exited_.clear();
+    for (const auto& event : events_) {
+        if (event.type != ProcConnector::Event::kExit || !event.has_stat) {
+            continue;
+        }
+        auto it = table_.find({event.pid, event.stat.starttime});
+        if (it != table_.end()) {
+            // A reconcile tick lists /proc in full and may have sampled the
+            // dying process already; a second Update() would measure it
+            // against itself
+            if (it->second.generation != generation_) {
+                it->second.process.Update(event.stat, uptime, elapsed);
+            }
+            // Swept below, even if the listing still showed it
+            it->second.generation = generation_ - 1;
+        } else {
+            exited_.push_back({event.pid, PooledString(event.stat.comm),
+                               event.stat.utime + event.stat.stime});
+        }
+    }
+
+    // Forget processes that were not seen in this refresh and lay the
+    // others out as rows
+    rows_.Clear();
+    tracked_.clear();
+    for (auto it = table_.begin(); it != table_.end();) {
+        if (it->second.generation != generation_) {
+            Process& process = it->second.process;
+            exited_.push_back(
+                {process.Pid(), process.Command(), process.ActiveJiffies()});
+            // Its children are filed under the new parent once the next
+            // sample shows them reparented
+            Reparent(it->second, -1);
+            auto indexed = by_pid_.find(it->first.pid);
+            if (indexed != by_pid_.end() && indexed->second == &it->second) {
+                by_pid_.erase(indexed);
+            }
+            it = table_.erase(it);
+        } else {
+            rows_.Append(it->second.process);
+            tracked_.push_back(&it->second);
+            ++it;
+        }
+    }
+}
+
+// File `tracked` under `parent` in the child index (-1 to remove it)
+void System::Reparent(TrackedProcess& tracked, int parent) {
+    if (tracked.parent >= 0) {
+        auto siblings = children_.find(tracked.parent);
+        if (siblings != children_.end()) {
+            auto& list = siblings->second;
+            auto it = std::find(list.begin(), list.end(), &tracked);
+            if (it != list.end()) {
+                *it = list.back();
+                list.pop_back();
+            }
+            if (list.empty()) {
+                children_.erase(siblings);
+            }
+        }
+    }
+    tracked.parent = parent;
+    if (parent >= 0) {
+        children_[parent].push_back(&tracked);
+    }
+}
+
+void System::TreeView(bool enabled) { tree_view_ = enabled; }
+
+bool System::TreeView() const { return tree_view_; }
+
+void System::TreeDepth(int depth) { tree_depth_ = std::max(depth, 1); }
+
+int System::TreeDepth() const { return tree_depth_; }
+
+// Lay the tree out in pre-order from the child index, sum every subtree
+// with one backward pass over that array (children come after their
+// parent, so each is complete before it is added to its parent), then walk
+// it again to pick the first n rows.
+void System::BuildTree(int n) {
+    tree_.clear();
+    for (TrackedProcess* root : tracked_) {
+        // Roots are the processes whose parent is not being tracked: PID 0
+        // (init and kthreadd) or hidden
+        if (by_pid_.count(root->parent) > 0) {
+            continue;
+        }
+        tree_stack_.assign(1, {root, -1});
+        while (!tree_stack_.empty()) {
+            auto [tracked, parent] = tree_stack_.back();
+            tree_stack_.pop_back();
+            const Process& process = tracked->process;
+            TreeNode node{tracked, parent, {}, 0.0};
+            node.tree.depth = parent < 0 ? 0 : tree_[parent].tree.depth + 1;
+            node.tree.cpu = process.CpuUtilization();
+            node.tree.rss_kb = process.RssKilobytes();
+            node.io = double(process.ReadRate()) + process.WriteRate();
+            int index = int(tree_.size());
+            tree_.push_back(node);
+            auto children = children_.find(process.Pid());
+            if (children == children_.end()) {
+                continue;
+            }
+            for (TrackedProcess* child : children->second) {
+                tree_stack_.push_back({child, index});
+            }
+        }
+    }
+
+    for (int i = int(tree_.size()) - 1; i >= 0; --i) {
+        const TreeNode& node = tree_[i];
+        if (node.parent < 0) {
+            continue;
+        }
+        Process::Tree& parent = tree_[node.parent].tree;
+        parent.cpu += node.tree.cpu;
+        parent.rss_kb += node.tree.rss_kb;
+        parent.descendants += node.tree.descendants + 1;
+        tree_[node.parent].io += node.io;
+    }
+
+    SortOrder order = sort_;
+    auto value = [&](int i) -> double {
+        switch (order) {
+            case SortOrder::kMemory:
+                return double(tree_[i].tree.rss_kb);
+            case SortOrder::kIo:
+                return tree_[i].io;
+            default:
+                return tree_[i].tree.cpu;
+        }
+    };
+    // Push the subtrees that start at `first` and follow each other up to
+    // `last`, so that the highest ranking is popped first
+    auto push_siblings = [&](int first, int last) {
+        siblings_.clear();
+        for (int i = first; i <= last; i += tree_[i].tree.descendants + 1) {
+            siblings_.push_back(i);
+        }
+        std::sort(siblings_.begin(), siblings_.end(), [&](int a, int b) {
+            double va = value(a), vb = value(b);
+            if (va != vb) return va < vb;
+            return tree_[a].tracked->process.Pid() >
+                   tree_[b].tracked->process.Pid();
+        });
+        tree_rows_.insert(tree_rows_.end(), siblings_.begin(),
+                          siblings_.end());
+    };
+    tree_rows_.clear();
+    push_siblings(0, int(tree_.size()) - 1);
+    int depth = tree_depth_;
+    while (!tree_rows_.empty() && int(processes_.size()) < n) {
+        int i = tree_rows_.back();
+        tree_rows_.pop_back();
+        TreeNode& node = tree_[i];
+        node.tree.collapsed =
+            node.tree.descendants > 0 && node.tree.depth + 1 >= depth;
+        processes_.push_back(node.tracked->process);
+        processes_.back().SetTreePosition(node.tree);
+        if (node.tree.descendants > 0 && !node.tree.collapsed) {
+            push_siblings(i + 1, i + node.tree.descendants);
+        }
+    }
+}
+
+// Filter the rows, then order the first n that passed
+void System::Rank(int n) {
+    selected_ = rows_.Select(filter_, order_);
+    ranked_ = std::min<std::size_t>(std::max(n, 0), selected_);
+    ProcessTable::Column column;
+    switch (SortOrder(sort_)) {
+        case SortOrder::kMemory:
+            column = ProcessTable::Column::kRss;
+            break;
+        case SortOrder::kIo:
+            column = ProcessTable::Column::kIo;
+            break;
+        default:
+            column = ProcessTable::Column::kCpu;
+            break;
+    }
+    rows_.Rank(column, order_, selected_, ranked_);
+}
+
+// Read smaps_rollup for the ranked processes whose sample is stale and for
+// this refresh's slice of the others. Kernel threads (no resident pages)
+// and processes that denied access are skipped.
+void System::SampleMemory() {
+    memory_due_.clear();
+    for (size_t i = 0; i < order_.size(); ++i) {
+        TrackedProcess* tracked = tracked_[order_[i]];
+        if (tracked->memory_denied || tracked->process.RssKilobytes() == 0) {
+            continue;
+        }
+        if (Scheduler::Due(Scheduler::kSmapsRollup, generation_,
+                           tracked->memory_sampled, i < ranked_,
+                           rows_.Pid(order_[i]), order_.size() - ranked_)) {
+            memory_due_.push_back(tracked);
+        }
     }
+    pool_.ParallelFor(memory_due_.size(), 8, [&](size_t begin, size_t end) {
+        INSTRUMENT_STAGE_CPU(kCollect);
+        for (size_t i = begin; i < end; ++i) {
+            TrackedProcess* tracked = memory_due_[i];
+            LinuxParser::SmapsRollupSnapshot detail;
+            if (LinuxParser::ReadSmapsRollup(tracked->process.Pid(), detail)) {
+                tracked->process.SetMemoryDetail(detail);
+            } else if (errno == EACCES || errno == EPERM) {
+                tracked->memory_denied = true;
+            }
+            tracked->memory_sampled = generation_;
+        }
+    });
+}
+
+// Read io for the processes it is due for, the same way. Those read by
+// Scan() this refresh are skipped.
+void System::SampleIo() {
+    io_due_.clear();
+    for (size_t i = 0; i < order_.size(); ++i) {
+        TrackedProcess* tracked = tracked_[order_[i]];
+        if (tracked->io_denied || tracked->io_sampled == generation_) {
+            continue;
+        }
+        if (Scheduler::Due(Scheduler::kIo, generation_, tracked->io_sampled,
+                           i < ranked_, rows_.Pid(order_[i]),
+                           order_.size() - ranked_)) {
+            io_due_.push_back(tracked);
+        }
+    }
+    pool_.ParallelFor(io_due_.size(), 16, [&](size_t begin, size_t end) {
+        INSTRUMENT_STAGE_CPU(kCollect);
+        for (size_t i = begin; i < end; ++i) {
+            TrackedProcess* tracked = io_due_[i];
+            LinuxParser::ProcIoSnapshot io;
+            if (LinuxParser::ReadProcIo(tracked->process.Pid(), io)) {
+                UpdateIo(*tracked, io);
+            } else if (errno == EACCES || errno == EPERM) {
+                tracked->io_denied = true;
+            }
+        }
+    });
+}
+
+// Rates are taken over the time since the process's previous io read,
+// which spans several refreshes for those read in slices
+void System::UpdateIo(TrackedProcess& tracked,
+                      const LinuxParser::ProcIoSnapshot& io) {
+    float elapsed = 0.0f;
+    if (tracked.io_sampled > 0) {
+        elapsed = std::chrono::duration<float>(last_refresh_ - tracked.io_time)
+                      .count();
+    }
+    tracked.process.UpdateIo(io, elapsed);
+    tracked.io_sampled = generation_;
+    tracked.io_time = last_refresh_;
+}
+
+void System::Filter(float min_cpu, const string& user,
+                    const string& command) {
+    filter_user_ = PooledString(user);
+    filter_command_ = PooledString(command);
+    filter_.min_cpu = min_cpu;
+    filter_.user = filter_user_.Id();
+    filter_.command = filter_command_.Id();
+}
+
+void System::Sort(SortOrder order) { sort_ = order; }
+
+System::SortOrder System::Sort() const { return sort_; }
 
-    sort(processes_.rbegin(), processes_.rend());
-    
-    return processes_; 
+const vector<System::ExitedProcess>& System::ExitedProcesses() const {
+    return exited_;
+}
+
+bool System::ProcEvents() const { return connector_.Running(); }
+
+const System::StageTimes& System::LastStageTimes() const {
+    return stage_times_;
 }
 
 // Return the system's kernel identifier (string)
-std::string System::Kernel() { return LinuxParser::Kernel(); }
+const std::string& System::Kernel() const { return kernel_; }
 
 // Return the system's memory utilization
-float System::MemoryUtilization() { return LinuxParser::MemoryUtilization(); }
+float System::MemoryUtilization() { return snapshot_.meminfo.Used(); }
+
+// Return the full /proc/meminfo model
+const LinuxParser::MemInfo& System::Memory() const { return snapshot_.meminfo; }
+
+const LoadAverage& System::Load() const { return snapshot_.load; }
+
+bool System::HasPressure() const { return snapshot_.has_pressure; }
+
+const Pressure& System::CpuPressure() const { return snapshot_.cpu_pressure; }
+
+const Pressure& System::MemoryPressure() const {
+    return snapshot_.memory_pressure;
+}
+
+const Pressure& System::IoPressure() const { return snapshot_.io_pressure; }
 
 // Return the operating system name
-std::string System::OperatingSystem() { return LinuxParser::OperatingSystem(); }
+const std::string& System::OperatingSystem() const {
+    return operating_system_;
+}
 
 // Return the number of processes actively running on the system
-int System::RunningProcesses() { return LinuxParser::RunningProcesses(); }
+int System::RunningProcesses() { return snapshot_.running_processes; }
 
 // Return the total number of processes on the system
-int System::TotalProcesses() { return LinuxParser::TotalProcesses(); }
+int System::TotalProcesses() { return snapshot_.total_processes; }
 
 // Return the number of seconds since the system started running
-long int System::UpTime() { return LinuxParser::UpTime(); }
\ No newline at end of file
+long int System::UpTime() { return long(snapshot_.uptime); }
\ No newline at end of file
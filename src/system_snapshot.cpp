@@ -0,0 +1,239 @@
+#include "system_snapshot.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "instrument.h"
+#include "linux_parser.h"
+#include "proc_reader.h"
+
+using ProcReader::FieldScanner;
+using std::string_view;
+
+namespace {
+// Call f(key, rest of line) for every line of `contents`
+template <typename F>
+void ForEachLine(string_view contents, F f) {
+  while (!contents.empty()) {
+    std::size_t next = contents.find('\n');
+    string_view line = contents.substr(0, next);
+    contents.remove_prefix(next == string_view::npos ? contents.size()
+                                                     : next + 1);
+    std::size_t key_end = line.find_first_of(" \t");
+    if (key_end == string_view::npos) continue;
+    f(line.substr(0, key_end), line.substr(key_end));
+  }
+}
+
+void ParseCpu(string_view value, CpuTimes& times) {
+  FieldScanner fields(value);
+  for (auto& jiffies : times) fields.Next(jiffies);
+}
+
+void ParseStat(string_view contents, SystemSnapshot& snapshot) {
+  std::size_t cores = 0;
+  ForEachLine(contents, [&](string_view key, string_view value) {
+    if (key == "cpu") {
+      ParseCpu(value, snapshot.cpu);
+    } else if (key.size() > 3 && key.compare(0, 3, "cpu") == 0) {
+      // Offline CPUs have no line, so the index comes from the name
+      std::size_t core = 0;
+      auto result =
+          std::from_chars(key.data() + 3, key.data() + key.size(), core);
+      if (result.ec != std::errc()) return;
+      if (core >= snapshot.cores.size()) snapshot.cores.resize(core + 1);
+      ParseCpu(value, snapshot.cores[core]);
+      cores = std::max(cores, core + 1);
+    } else if (key == LinuxParser::filterProcesses) {
+      FieldScanner(value).Next(snapshot.total_processes);
+    } else if (key == LinuxParser::filterRunningProcesses) {
+      FieldScanner(value).Next(snapshot.running_processes);
+    }
+  });
+  snapshot.cores.resize(cores);
+}
+
+// "0.52 0.48 0.40 2/1234 5678"
+void ParseLoadAverage(string_view contents, LoadAverage& load) {
+  FieldScanner fields(contents);
+  fields.Next(load.one);
+  fields.Next(load.five);
+  fields.Next(load.fifteen);
+  string_view entities = fields.NextToken();
+  std::size_t slash = entities.find('/');
+  if (slash == string_view::npos) return;
+  std::from_chars(entities.data(), entities.data() + slash, load.runnable);
+  std::from_chars(entities.data() + slash + 1,
+                  entities.data() + entities.size(), load.total);
+}
+
+// "some avg10=0.12 avg60=0.05 avg300=0.01 total=123456", then "full ..."
+void ParsePressure(string_view contents, Pressure& pressure) {
+  ForEachLine(contents, [&](string_view key, string_view value) {
+    Pressure::Line* line = key == "some"   ? &pressure.some
+                           : key == "full" ? &pressure.full
+                                           : nullptr;
+    if (line == nullptr) return;
+    FieldScanner fields(value);
+    for (string_view field = fields.NextToken(); !field.empty();
+         field = fields.NextToken()) {
+      std::size_t equals = field.find('=');
+      if (equals == string_view::npos) continue;
+      string_view name = field.substr(0, equals);
+      FieldScanner number(field.substr(equals + 1));
+      if (name == "avg10") {
+        number.Next(line->avg10);
+      } else if (name == "avg60") {
+        number.Next(line->avg60);
+      } else if (name == "avg300") {
+        number.Next(line->avg300);
+      } else if (name == "total") {
+        number.Next(line->total_us);
+      }
+    }
+  });
+}
+}  // namespace
+
+SystemSampler::SystemSampler() {
+  Open(stat_, LinuxParser::kProcDirectory + LinuxParser::kStatFilename);
+  Open(meminfo_, LinuxParser::kProcDirectory + LinuxParser::kMeminfoFilename);
+  Open(uptime_, LinuxParser::kProcDirectory + LinuxParser::kUptimeFilename);
+  Open(diskstats_,
+       LinuxParser::kProcDirectory + LinuxParser::kDiskstatsFilename);
+  Open(loadavg_, LinuxParser::kProcDirectory + LinuxParser::kLoadavgFilename);
+  std::string pressure =
+      LinuxParser::kProcDirectory + LinuxParser::kPressureDirectory;
+  Open(cpu_pressure_, pressure + "/cpu");
+  Open(memory_pressure_, pressure + "/memory");
+  Open(io_pressure_, pressure + "/io");
+}
+
+SystemSampler::~SystemSampler() {
+  for (File* file : {&stat_, &meminfo_, &uptime_, &diskstats_, &loadavg_,
+                     &cpu_pressure_, &memory_pressure_, &io_pressure_}) {
+    if (file->fd >= 0) close(file->fd);
+  }
+}
+
+void SystemSampler::Open(File& file, const std::string& path) {
+  file.fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  file.buffer.resize(4096);
+}
+
+// proc files regenerate their contents when read from offset 0, so one
+// pread() per tick is enough. The buffer doubles (and the read is retried)
+// only when the file has outgrown it.
+bool SystemSampler::Read(File& file, string_view& contents) {
+  if (file.fd < 0) {
+    return false;
+  }
+  while (true) {
+    ssize_t size = pread(file.fd, file.buffer.data(), file.buffer.size(), 0);
+    INSTRUMENT_SYSCALLS(1);
+    if (size < 0) {
+      return false;
+    }
+    INSTRUMENT_READ(size);
+    if (static_cast<std::size_t>(size) < file.buffer.size()) {
+      contents = string_view(file.buffer.data(), size);
+      return true;
+    }
+    file.buffer.resize(file.buffer.size() * 2);
+  }
+}
+
+bool SystemSampler::Refresh(SystemSnapshot& snapshot) {
+  string_view contents;
+  bool complete = true;
+  if (Read(stat_, contents)) {
+    ParseStat(contents, snapshot);
+  } else {
+    complete = false;
+  }
+  if (Read(meminfo_, contents)) {
+    LinuxParser::ParseMemInfo(contents, snapshot.meminfo);
+  } else {
+    complete = false;
+  }
+  if (Read(uptime_, contents)) {
+    FieldScanner(contents).Next(snapshot.uptime);
+  } else {
+    complete = false;
+  }
+  // Missing in some containers; the disk line is simply left empty
+  if (Read(diskstats_, contents)) {
+    ParseDiskstats(contents, snapshot);
+  }
+  if (Read(loadavg_, contents)) {
+    ParseLoadAverage(contents, snapshot.load);
+  } else {
+    complete = false;
+  }
+  snapshot.has_pressure = true;
+  for (auto [file, pressure] :
+       {std::pair{&cpu_pressure_, &snapshot.cpu_pressure},
+        std::pair{&memory_pressure_, &snapshot.memory_pressure},
+        std::pair{&io_pressure_, &snapshot.io_pressure}}) {
+    if (Read(*file, contents)) {
+      ParsePressure(contents, *pressure);
+    } else {
+      snapshot.has_pressure = false;
+    }
+  }
+  return complete;
+}
+
+// "major minor name reads merged sectors ms writes merged sectors ms
+// in_flight io_ms ..." for every block device
+void SystemSampler::ParseDiskstats(string_view contents,
+                                   SystemSnapshot& snapshot) {
+  std::size_t count = 0;
+  while (!contents.empty()) {
+    std::size_t next = contents.find('\n');
+    string_view line = contents.substr(0, next);
+    contents.remove_prefix(next == string_view::npos ? contents.size()
+                                                     : next + 1);
+    FieldScanner fields(line);
+    fields.Skip(2);
+    string_view name = fields.NextToken();
+    if (name.empty() || name.size() >= sizeof(DiskCounters::name)) continue;
+    DiskCounters counters;
+    fields.Skip(2);
+    fields.Next(counters.sectors_read);
+    fields.Skip(3);
+    fields.Next(counters.sectors_written);
+    fields.Skip(2);
+    fields.Next(counters.io_ms);
+    // Devices that never did any I/O (unused loop and ram disks) are noise
+    if (counters.sectors_read + counters.sectors_written == 0 ||
+        !WholeDisk(name)) {
+      continue;
+    }
+    std::memcpy(counters.name, name.data(), name.size());
+    if (count == snapshot.disks.size()) snapshot.disks.emplace_back();
+    snapshot.disks[count++] = counters;
+  }
+  snapshot.disks.resize(count);
+}
+
+bool SystemSampler::WholeDisk(std::string_view name) {
+  for (const auto& [known, whole] : whole_disks_) {
+    if (known == name) {
+      return whole;
+    }
+  }
+  // Partitions have no /sys/block entry of their own
+  std::string path = "/sys/block/";
+  path += name;
+  bool whole = access(path.c_str(), F_OK) == 0;
+  whole_disks_.emplace_back(name, whole);
+  return whole;
+}
@@ -0,0 +1,113 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned threads) {
+  threads = std::max(threads, 1u);
+  for (unsigned i = 0; i < threads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  // Queue 0 belongs to the thread calling ParallelFor
+  for (unsigned i = 1; i < threads; ++i) {
+    workers_.emplace_back(&ThreadPool::Worker, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+unsigned ThreadPool::Size() const { return queues_.size(); }
+
+void ThreadPool::ParallelFor(
+    std::size_t count, std::size_t chunk,
+    const std::function<void(std::size_t, std::size_t)>& task) {
+  if (count == 0) {
+    return;
+  }
+  chunk = std::max<std::size_t>(chunk, 1);
+  if (workers_.empty() || count <= chunk) {
+    task(0, count);
+    return;
+  }
+
+  // The task and the chunk count are published before any range, so a
+  // worker that pops a range always sees the matching task
+  task_ = &task;
+  pending_ = (count + chunk - 1) / chunk;
+  std::size_t queue = 0;
+  for (std::size_t begin = 0; begin < count; begin += chunk) {
+    Queue& target = *queues_[queue];
+    {
+      std::lock_guard<std::mutex> lock(target.mutex);
+      target.ranges.push_back({begin, std::min(begin + chunk, count)});
+    }
+    queue = (queue + 1) % queues_.size();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++batch_;
+  }
+  wake_.notify_all();
+
+  RunTasks(0);
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return pending_ == 0; });
+  task_ = nullptr;
+}
+
+void ThreadPool::Worker(unsigned index) {
+  unsigned long seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [&] { return stop_ || batch_ != seen; });
+      if (stop_) {
+        return;
+      }
+      seen = batch_;
+    }
+    RunTasks(index);
+  }
+}
+
+void ThreadPool::RunTasks(unsigned index) {
+  Range range;
+  while (Pop(index, range)) {
+    (*task_)(range.begin, range.end);
+    if (--pending_ == 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_.notify_all();
+    }
+  }
+}
+
+// Own queue first (front), then steal from the back of the others
+bool ThreadPool::Pop(unsigned index, Range& range) {
+  {
+    Queue& own = *queues_[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.ranges.empty()) {
+      range = own.ranges.front();
+      own.ranges.pop_front();
+      return true;
+    }
+  }
+  for (std::size_t i = 1; i < queues_.size(); ++i) {
+    Queue& victim = *queues_[(index + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.ranges.empty()) {
+      range = victim.ranges.back();
+      victim.ranges.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,112 @@
+#include "user_cache.h"
+
+#include <pwd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <charconv>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "instrument.h"
+#include "proc_reader.h"
+
+using std::string;
+
+UserCache::UserCache(string path, std::chrono::seconds negative_ttl)
+    : path_(std::move(path)), negative_ttl_(negative_ttl) {
+  Refresh();
+}
+
+// Reload the password file only when it was replaced or modified
+void UserCache::Refresh() {
+  struct stat info {};
+  INSTRUMENT_SYSCALLS(1);
+  if (stat(path_.c_str(), &info) != 0) {
+    return;
+  }
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (info.st_dev == device_ && info.st_ino == inode_ &&
+        info.st_mtim.tv_sec == modified_.tv_sec &&
+        info.st_mtim.tv_nsec == modified_.tv_nsec) {
+      return;
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  device_ = info.st_dev;
+  inode_ = info.st_ino;
+  modified_ = info.st_mtim;
+  Load();
+}
+
+// https://www.cyberciti.biz/faq/understanding-etcpasswd-file-format/
+// name:password:UID:GID:GECOS:home:shell
+void UserCache::Load() {
+  names_.clear();
+  misses_.clear();
+  std::string_view contents;
+  if (!ProcReader::ReadPath(path_, contents)) {
+    return;
+  }
+  while (!contents.empty()) {
+    std::size_t next = contents.find('\n');
+    std::string_view line = contents.substr(0, next);
+    contents.remove_prefix(next == std::string_view::npos ? contents.size()
+                                                          : next + 1);
+    std::size_t name_end = line.find(':');
+    if (name_end == std::string_view::npos) continue;
+    std::size_t uid_begin = line.find(':', name_end + 1);
+    if (uid_begin == std::string_view::npos) continue;
+    ++uid_begin;
+    std::size_t uid_end = line.find(':', uid_begin);
+    if (uid_end == std::string_view::npos) continue;
+    uid_t uid = 0;
+    auto result = std::from_chars(line.data() + uid_begin,
+                                  line.data() + uid_end, uid);
+    // The first entry for a UID wins, as with getpwuid
+    if (result.ec == std::errc() && result.ptr == line.data() + uid_end) {
+      names_.emplace(uid, PooledString(line.substr(0, name_end)));
+    }
+  }
+}
+
+// Ask NSS, which also covers directory users missing from the file
+bool UserCache::LookupSystem(uid_t uid, string& name) {
+  long size = sysconf(_SC_GETPW_R_SIZE_MAX);
+  std::vector<char> buffer(size > 0 ? size : 16384);
+  struct passwd entry {};
+  struct passwd* result = nullptr;
+  if (getpwuid_r(uid, &entry, buffer.data(), buffer.size(), &result) != 0 ||
+      result == nullptr) {
+    return false;
+  }
+  name = result->pw_name;
+  return true;
+}
+
+PooledString UserCache::Name(uid_t uid) {
+  auto now = std::chrono::steady_clock::now();
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto name = names_.find(uid);
+    if (name != names_.end()) {
+      return name->second;
+    }
+    auto miss = misses_.find(uid);
+    if (miss != misses_.end() && now < miss->second) {
+      return PooledString(std::to_string(uid));
+    }
+  }
+
+  string name;
+  bool found = LookupSystem(uid, name);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (found) {
+    return names_.emplace(uid, PooledString(name)).first->second;
+  }
+  misses_[uid] = now + negative_ttl_;
+  return PooledString(std::to_string(uid));
+}